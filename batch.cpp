@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include "batch.h"
+
+// 一个要分析的局面
+typedef struct batchJob {
+    char szFen[128];            // 棋盘和走子方
+    int nLine;                  // 在文件中的行号，输出结果时标明是哪个局面
+    int nDepth;                 // 这个局面的限制，都是 0 时按默认深度
+    int64_t nNodes;
+    int nTime;
+} batchJob;
+
+// 一个工作线程，局面和搜索结构都是自己的，不用全局的 pos 和 Search
+typedef struct batchWorker {
+    searchStruct search;
+    positionStruct pos;
+    int nPositions;             // 这个线程分析的局面数
+    int64_t nNodes;             // 这个线程搜索的节点数
+} batchWorker;
+
+// 所有工作线程共用的任务表和输出
+typedef struct batchStruct {
+    batchJob* jobs;
+    int nJobs;
+    std::atomic<int> nNext;     // 下一个没人取的局面
+    std::mutex mtxOutput;       // 一行结果一次输出完
+} batchStruct;
+
+// 在一行中找单词 szWord，找到返回后面的内容，没找到返回 NULL
+const char* findWord(const char* szLine, const char* szWord) {
+    size_t n = strlen(szWord);
+    const char* p = szLine;
+    while ((p = strstr(p, szWord)) != NULL) {
+        if ((p == szLine || p[-1] == ' ' || p[-1] == '\t') && (p[n] == ' ' || p[n] == '\t')) {
+            return p + n;
+        }
+        p += n;
+    }
+    return NULL;
+}
+
+// 读入任务表，失败返回 NULL
+batchJob* batchLoad(const char* szFile, int* lpJobs) {
+    char szLine[1024];
+    const char* p;
+    const char* q;
+    int nLine, nJobs, nMaxJobs;
+    size_t n;
+    batchJob* jobs;
+    batchJob* jobsNew;
+    FILE* fp;
+
+    fp = fopen(szFile, "r");
+    if (fp == NULL) {
+        printf("cannot open %s\n", szFile);
+        return NULL;
+    }
+    nJobs = 0;
+    nMaxJobs = 1024;
+    jobs = (batchJob*)malloc(nMaxJobs * sizeof(batchJob));
+    nLine = 0;
+    while (jobs != NULL && fgets(szLine, sizeof(szLine), fp) != NULL) {
+        nLine++;
+        p = szLine;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '#' || *p == '\r' || *p == '\n' || *p == '\0') {
+            continue;
+        }
+        if (nJobs == nMaxJobs) {
+            nMaxJobs *= 2;
+            jobsNew = (batchJob*)realloc(jobs, nMaxJobs * sizeof(batchJob));
+            if (jobsNew == NULL) {
+                free(jobs);
+            }
+            jobs = jobsNew;
+            if (jobs == NULL) {
+                break;
+            }
+        }
+        // FEN 串到第一个限制为止，限制的值在单词后面
+        n = strcspn(p, "\r\n");
+        q = findWord(p, "depth");
+        jobs[nJobs].nDepth = q == NULL ? 0 : atoi(q);
+        n = q != NULL && (size_t)(q - 5 - p) < n ? (size_t)(q - 5 - p) : n;
+        q = findWord(p, "nodes");
+        jobs[nJobs].nNodes = q == NULL ? 0 : atoll(q);
+        n = q != NULL && (size_t)(q - 5 - p) < n ? (size_t)(q - 5 - p) : n;
+        q = findWord(p, "movetime");
+        jobs[nJobs].nTime = q == NULL ? 0 : atoi(q);
+        n = q != NULL && (size_t)(q - 8 - p) < n ? (size_t)(q - 8 - p) : n;
+        n = n < sizeof(jobs[nJobs].szFen) - 1 ? n : sizeof(jobs[nJobs].szFen) - 1;
+        memcpy(jobs[nJobs].szFen, p, n);
+        while (n > 0 && (jobs[nJobs].szFen[n - 1] == ' ' || jobs[nJobs].szFen[n - 1] == '\t')) {
+            n--;
+        }
+        jobs[nJobs].szFen[n] = '\0';
+        jobs[nJobs].nLine = nLine;
+        nJobs++;
+    }
+    fclose(fp);
+    *lpJobs = nJobs;
+    return jobs;
+}
+
+// 工作线程：不断取下一个局面搜索，搜完马上输出
+void batchWork(batchStruct* lpBatch, batchWorker* lpWorker, int nDepth) {
+    int i;
+    int64_t t;
+    char szMove[5];
+    batchJob* job;
+    searchStruct* lpSearch = &lpWorker->search;
+
+    while ((i = lpBatch->nNext++) < lpBatch->nJobs) {
+        job = &lpBatch->jobs[i];
+        if (!fromFen(&lpWorker->pos, job->szFen)) {
+            std::lock_guard<std::mutex> lock(lpBatch->mtxOutput);
+            printf("line %d error fen %s\n", job->nLine, job->szFen);
+            fflush(stdout);
+            continue;
+        }
+        lpSearch->nMaxDepth = job->nDepth;
+        lpSearch->nMaxNodes = job->nNodes;
+        lpSearch->nMaxTime = job->nTime;
+        if (job->nDepth == 0 && job->nNodes == 0 && job->nTime == 0) {
+            lpSearch->nMaxDepth = nDepth;
+        }
+        lpSearch->nClockTime = 0;
+        lpSearch->bStop = false;
+        t = searchClock();
+        searchMain(lpSearch, &lpWorker->pos);
+        t = searchClock() - t;
+        lpWorker->nPositions++;
+        lpWorker->nNodes += lpSearch->nNodes;
+
+        moveToStr(lpSearch->mvResult, szMove);
+        std::lock_guard<std::mutex> lock(lpBatch->mtxOutput);
+        printf("line %d bestmove %s score %d depth %d nodes %lld time %lld fen %s\n", job->nLine,
+               lpSearch->mvResult == 0 ? "none" : szMove, lpSearch->vlResult, lpSearch->nDepthResult,
+               (long long)lpSearch->nNodes, (long long)t, job->szFen);
+        fflush(stdout);
+    }
+}
+
+bool batchAnalyse(const char* szFile, int nWorkers, int nDepth) {
+    int i, nPositions;
+    int64_t t, nNodes;
+    batchStruct batch;
+    batchWorker* workers[MAX_THREADS];
+    std::thread threads[MAX_THREADS];
+
+    // 1. 读入所有局面
+    batch.jobs = batchLoad(szFile, &batch.nJobs);
+    if (batch.jobs == NULL) {
+        return false;
+    }
+    batch.nNext = 0;
+    if (nWorkers <= 0) {
+        nWorkers = (int)std::thread::hardware_concurrency();
+    }
+    nWorkers = nWorkers < 1 ? 1 : nWorkers > MAX_THREADS ? MAX_THREADS : nWorkers;
+    nDepth = nDepth > 0 ? nDepth : BATCH_DEPTH;
+
+    // 2. 每个工作线程一个单线程的搜索，选项(包括局面评价的余量)从全局的 Search 复制，搜索时只用自己的这一份
+    for (i = 0; i < nWorkers; i++) {
+        workers[i] = new batchWorker();
+        workers[i]->search.bPvs = Search.bPvs;
+        workers[i]->search.bAspiration = Search.bAspiration;
+        workers[i]->search.bNullMove = Search.bNullMove;
+        workers[i]->search.bNullVerify = Search.bNullVerify;
+        workers[i]->search.bLmr = Search.bLmr;
+        workers[i]->search.vlLazyMargin1 = Search.vlLazyMargin1;
+        workers[i]->search.vlLazyMargin2 = Search.vlLazyMargin2;
+        if (!threadsInit(1, &workers[i]->search)) {
+            delete workers[i];
+            nWorkers = i;
+            break;
+        }
+    }
+
+    // 3. 同时搜索，结果随搜随出
+    t = searchClock();
+    for (i = 0; i < nWorkers; i++) {
+        threads[i] = std::thread(batchWork, &batch, workers[i], nDepth);
+    }
+    nPositions = 0;
+    nNodes = 0;
+    for (i = 0; i < nWorkers; i++) {
+        threads[i].join();
+        nPositions += workers[i]->nPositions;
+        nNodes += workers[i]->nNodes;
+        free(workers[i]->search.threads);
+        delete workers[i];
+    }
+    t = searchClock() - t;
+    printf("positions %d workers %d time %lld positions/s %.1f nodes %lld nps %lld\n", nPositions, nWorkers,
+           (long long)t, nPositions * 1000.0 / (t > 0 ? t : 1), (long long)nNodes,
+           (long long)(nNodes * 1000 / (t > 0 ? t : 1)));
+    fflush(stdout);
+    free(batch.jobs);
+    return true;
+}
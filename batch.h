@@ -0,0 +1,16 @@
+#ifndef LVENW_BATCH_H
+#define LVENW_BATCH_H
+
+// 批量分析：从文件读入局面，分给几个工作线程同时搜索。每个工作线程有自己的局面和搜索结构，
+// 只共用置换表。文件每行一个局面，先是 FEN 串(棋盘和走子方)，后面可以跟 "depth <d>"、
+// "nodes <n>"、"movetime <ms>" 限制这个局面的搜索，什么都没给的按默认深度搜索；
+// 空行和 '#' 开头的行跳过。每搜完一个局面就输出一行结果，最后输出每秒分析的局面数
+
+#include "engine.h"
+
+#define BATCH_DEPTH     8                   // 默认的搜索深度
+
+// nWorkers 是工作线程数，0 表示 CPU 的核数；文件打不开返回 false
+bool batchAnalyse(const char* szFile, int nWorkers, int nDepth);
+
+#endif
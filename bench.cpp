@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <chrono>
+#include "bench.h"
+#include "nnue.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define EVAL_REPEAT     16      // benchEval 计时时每个局面评价的次数
+#define BENCH_MATED_NODES 100000  // benchSearch 搜索被将死的局面时的节点数限制
+
+// 测试局面：开局、中局和残局各一个
+const char* const benchFens[] = {
+    "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w",
+    "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w",
+    "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w",
+};
+
+// 被将死的局面：没有合法走法，搜索要马上结束，给出杀棋分值
+const char* const benchMatedFen = "5k3/4R4/9/9/9/9/9/9/9/3K5 b";
+
+void benchSearch(int nDepth) {
+    int i;
+    int64_t t, tTotal = 0, nNodes = 0, nReduced = 0, nPlies = 0, nResearched = 0;
+    int nFens = (int)(sizeof(benchFens) / sizeof(benchFens[0]));
+    char szMove[5];
+    positionStruct posSaved = pos;  // 测试完恢复原来的局面
+
+    Search.nMaxDepth = nDepth;
+    Search.nMaxTime = 0;
+    Search.nClockTime = 0;
+    Search.nMaxNodes = 0;
+    Search.bStop = false;
+    for (i = 0; i < nFens; i++) {
+        fromFen(&pos, benchFens[i]);
+        hashClear();
+        t = searchClock();
+        searchMain();
+        t = searchClock() - t;
+        tTotal += t;
+        nNodes += Search.nNodes;
+        nReduced += Search.nLmrReduced;
+        nPlies += Search.nLmrPlies;
+        nResearched += Search.nLmrResearched;
+        moveToStr(Search.mvResult, szMove);
+        printf("%s depth %d bestmove %s score %d nodes %lld time %lld\n", benchFens[i],
+               Search.nDepthResult, szMove, Search.vlResult, (long long)Search.nNodes, (long long)t);
+    }
+    printf("total nodes %lld time %lld nps %lld\n", (long long)nNodes, (long long)tTotal,
+           (long long)(nNodes * 1000 / (tTotal > 0 ? tTotal : 1)));
+    printf("lmr reduced %lld plies %lld researched %lld\n", (long long)nReduced, (long long)nPlies,
+           (long long)nResearched);
+
+    // 限制节点数，搜索停不下来时输出 failed 而不是一直搜下去
+    fromFen(&pos, benchMatedFen);
+    hashClear();
+    Search.nMaxNodes = BENCH_MATED_NODES;
+    searchMain();
+    Search.nMaxNodes = 0;
+    printf("mated depth %d score %d nodes %lld %s\n", Search.nDepthResult, Search.vlResult,
+           (long long)Search.nNodes, Search.mvResult == 0 && Search.vlResult == -MATE_VALUE ? "ok" : "failed");
+    fflush(stdout);
+    pos = posSaved;
+}
+
+void benchThreads(int nDepth) {
+    int i, k, nThreads;
+    int64_t t, tTotal, tSingle, nNodes;
+    int nFens = (int)(sizeof(benchFens) / sizeof(benchFens[0]));
+
+    Search.nMaxDepth = nDepth;
+    Search.nMaxTime = 0;
+    Search.nClockTime = 0;
+    Search.nMaxNodes = 0;
+    Search.bStop = false;
+    tSingle = 0;
+    for (nThreads = 1; nThreads <= 32; nThreads *= 2) {
+        if (!threadsInit(nThreads)) {
+            break;
+        }
+        tTotal = nNodes = 0;
+        // 每个局面都从空的置换表开始，用时是到达 nDepth 层的墙上时间
+        for (i = 0; i < nFens; i++) {
+            fromFen(&pos, benchFens[i]);
+            hashClear();
+            t = searchClock();
+            searchMain();
+            t = searchClock() - t;
+            tTotal += t;
+            nNodes += Search.nNodes;
+        }
+        if (nThreads == 1) {
+            tSingle = tTotal;
+        }
+        k = (int)(tSingle * 100 / (tTotal > 0 ? tTotal : 1));
+        printf("threads %2d depth %d time %lld nodes %lld nps %lld speedup %d.%02d\n", nThreads,
+               nDepth, (long long)tTotal, (long long)nNodes,
+               (long long)(nNodes * 1000 / (tTotal > 0 ? tTotal : 1)), k / 100, k % 100);
+        fflush(stdout);
+    }
+    threadsInit(1);
+}
+
+// 只算前 nTiers 层的评价：余量设成 0，窗口在分值之上，算完这几层就返回
+int evalTiers(positionStruct* pos, int nTiers) {
+    searchStruct search;
+    search.vlLazyMargin1 = nTiers <= 1 ? 0 : MATE_VALUE * 2;
+    search.vlLazyMargin2 = nTiers <= 2 ? 0 : MATE_VALUE * 2;
+    return evaluate(pos, MATE_VALUE - 1, MATE_VALUE, &search);
+}
+
+void benchEval(int nPositions) {
+    int i, j, n, nGenMoves, pcCaptured, vl1, vl2, vlFull, vlLazy, vlAlpha, vlBeta;
+    int nMax23 = 0, nMax3 = 0, nExit1 = 0, nExit2 = 0, nWrong = 0;
+    int mvs[MAX_GEN_MOVES];
+    int nFens = (int)(sizeof(benchFens) / sizeof(benchFens[0]));
+    uint64_t nSeed = 1;
+    int64_t tFull = 0, tLazy = 0;
+    std::chrono::steady_clock::time_point t0, t1, t2;
+    pinStruct pins;
+    positionStruct posSaved = pos;  // 测试完恢复原来的局面
+
+    n = 0;
+    for (i = 0; n < nPositions; i++) {
+        // 1. 从测试局面出发随机走棋，每个不被将军的局面检查一次
+        fromFen(&pos, benchFens[i % nFens]);
+        for (j = 0; j < 80 && n < nPositions; j++) {
+            initPins(&pos, &pins);
+            nGenMoves = generateLegalMoves(&pos, &pins, mvs);
+            if (nGenMoves == 0) {
+                break;
+            }
+            nSeed = nSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+            makeLegalMove(&pos, mvs[(nSeed >> 33) % (uint64_t)nGenMoves], &pcCaptured);
+            if (pos.moveStack[pos.nMoveNum - 1].bCheck) {
+                continue;
+            }
+            n++;
+
+            // 2. 后两层、最后一层分值的最大绝对值，余量不能比它们小
+            vl1 = evalTiers(&pos, 1);
+            vl2 = evalTiers(&pos, 2);
+            vlFull = evaluate(&pos);
+            if (abs(vlFull - vl1) > nMax23) {
+                nMax23 = abs(vlFull - vl1);
+            }
+            if (abs(vlFull - vl2) > nMax3) {
+                nMax3 = abs(vlFull - vl2);
+            }
+
+            // 3. 在完整评价附近取一个窗口，偏移 -256 到 255，宽度 1 到 64；
+            // 惰性评价和完整评价要落在窗口的同一边，在窗口内时要相等
+            nSeed = nSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+            vlAlpha = vlFull + (int)((nSeed >> 33) % 512) - 256;
+            vlBeta = vlAlpha + 1 + (int)((nSeed >> 50) % 64);
+            vlLazy = evaluate(&pos, vlAlpha, vlBeta);
+            if ((vlLazy <= vlAlpha) != (vlFull <= vlAlpha) || (vlLazy >= vlBeta) != (vlFull >= vlBeta) ||
+                (vlLazy > vlAlpha && vlLazy < vlBeta && vlLazy != vlFull)) {
+                nWrong++;
+            }
+            if (vl1 + Search.vlLazyMargin1 <= vlAlpha || vl1 - Search.vlLazyMargin1 >= vlBeta) {
+                nExit1++;
+            }
+            else if (vl2 + Search.vlLazyMargin2 <= vlAlpha || vl2 - Search.vlLazyMargin2 >= vlBeta) {
+                nExit2++;
+            }
+
+            // 4. 同一个局面重复评价，比较完整评价和惰性评价的用时
+            t0 = std::chrono::steady_clock::now();
+            for (vl1 = 0; vl1 < EVAL_REPEAT; vl1++) {
+                evaluate(&pos);
+            }
+            t1 = std::chrono::steady_clock::now();
+            for (vl1 = 0; vl1 < EVAL_REPEAT; vl1++) {
+                evaluate(&pos, vlAlpha, vlBeta);
+            }
+            t2 = std::chrono::steady_clock::now();
+            tFull += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            tLazy += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+        }
+    }
+    printf("positions %d max tier2+3 %d max tier3 %d\n", n, nMax23, nMax3);
+    printf("margins %d %d exit tier1 %.1f%% tier2 %.1f%% full %.1f%% wrong %d\n", Search.vlLazyMargin1,
+           Search.vlLazyMargin2, nExit1 * 100.0 / n, nExit2 * 100.0 / n, (n - nExit1 - nExit2) * 100.0 / n,
+           nWrong);
+    printf("full %lld evals/s lazy %lld evals/s\n",
+           (long long)((int64_t)n * EVAL_REPEAT * 1000000000 / (tFull > 0 ? tFull : 1)),
+           (long long)((int64_t)n * EVAL_REPEAT * 1000000000 / (tLazy > 0 ? tLazy : 1)));
+    fflush(stdout);
+    pos = posSaved;
+}
+
+#ifdef USE_NNUE
+void benchNnue(int nPositions) {
+    int i, j, k, n, nGenMoves, pcCaptured, nMismatches;
+    int mvs[MAX_GEN_MOVES];
+    int nFens = (int)(sizeof(benchFens) / sizeof(benchFens[0]));
+    uint64_t nSeed = 1;
+    int64_t tIncremental = 0, tRefresh = 0, tClassic = 0;
+    std::chrono::steady_clock::time_point t0, t1, t2, t3;
+    nnueAccumulator accSaved;
+    pinStruct pins;
+    positionStruct posSaved = pos;  // 测试完恢复原来的局面
+
+    printf("simd %s weights %s\n", nnueSimd(), Nnue.bLoaded ? "file" : "random");
+    if (!Nnue.bLoaded) {
+        nnueRandom();
+    }
+    n = nMismatches = 0;
+    for (i = 0; n < nPositions; i++) {
+        // 1. 从测试局面出发随机走棋，累加器一直增量更新
+        fromFen(&pos, benchFens[i % nFens]);
+        for (j = 0; j < 80 && n < nPositions; j++) {
+            initPins(&pos, &pins);
+            nGenMoves = generateLegalMoves(&pos, &pins, mvs);
+            if (nGenMoves == 0) {
+                break;
+            }
+            nSeed = nSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+            makeLegalMove(&pos, mvs[(nSeed >> 33) % (uint64_t)nGenMoves], &pcCaptured);
+            n++;
+
+            // 2. 增量更新的累加器要和重算的一样
+            nnueEvaluate(&pos);
+            accSaved = pos.acc;
+            nnueRefresh(&pos, 0);
+            nnueRefresh(&pos, 1);
+            if (memcmp(accSaved.vls, pos.acc.vls, sizeof(accSaved.vls)) != 0) {
+                nMismatches++;
+            }
+            pos.acc = accSaved;
+
+            // 3. 增量更新后的评价、重算累加器后的评价和原来的评价分别计时
+            t0 = std::chrono::steady_clock::now();
+            for (k = 0; k < EVAL_REPEAT; k++) {
+                nnueEvaluate(&pos);
+            }
+            t1 = std::chrono::steady_clock::now();
+            for (k = 0; k < EVAL_REPEAT; k++) {
+                pos.acc.bDirty[0] = pos.acc.bDirty[1] = true;
+                nnueEvaluate(&pos);
+            }
+            t2 = std::chrono::steady_clock::now();
+            Nnue.bLoaded = false;
+            for (k = 0; k < EVAL_REPEAT; k++) {
+                evaluate(&pos);
+            }
+            Nnue.bLoaded = true;
+            t3 = std::chrono::steady_clock::now();
+            tIncremental += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            tRefresh += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+            tClassic += std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count();
+        }
+    }
+    printf("positions %d mismatches %d\n", n, nMismatches);
+    printf("incremental %lld evals/s refresh %lld evals/s classic %lld evals/s\n",
+           (long long)((int64_t)n * EVAL_REPEAT * 1000000000 / (tIncremental > 0 ? tIncremental : 1)),
+           (long long)((int64_t)n * EVAL_REPEAT * 1000000000 / (tRefresh > 0 ? tRefresh : 1)),
+           (long long)((int64_t)n * EVAL_REPEAT * 1000000000 / (tClassic > 0 ? tClassic : 1)));
+    fflush(stdout);
+    pos = posSaved;
+    pos.acc.bDirty[0] = pos.acc.bDirty[1] = true;
+}
+#endif
+
+#ifdef __linux__
+// 打开一个只统计本进程用户态的一级数据缓存计数器，nResult 是 PERF_COUNT_HW_CACHE_RESULT_*
+int perfOpen(int nResult, int fdGroup) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (nResult << 16);
+    attr.disabled = fdGroup == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, fdGroup, 0);
+}
+#endif
+
+void benchCache(int nDepth) {
+#ifdef __linux__
+    int i, fdAccess, fdMiss;
+    int64_t nNodes, nAccess, nMiss, nTotalNodes = 0, nTotalAccess = 0, nTotalMiss = 0;
+    int nFens = (int)(sizeof(benchFens) / sizeof(benchFens[0]));
+
+#ifdef COMPACT_TABLES
+    printf("layout compact\n");
+#else
+    printf("layout default\n");
+#endif
+    // 1. 读访问和读缺失放在一组，同时开始、同时停止
+    fdAccess = perfOpen(PERF_COUNT_HW_CACHE_RESULT_ACCESS, -1);
+    fdMiss = fdAccess < 0 ? -1 : perfOpen(PERF_COUNT_HW_CACHE_RESULT_MISS, fdAccess);
+    if (fdMiss < 0) {
+        printf("L1D counters not available\n");
+        fflush(stdout);
+        if (fdAccess >= 0) {
+            close(fdAccess);
+        }
+        return;
+    }
+
+    // 2. 单线程搜索，计数器只包住 searchMain，时间基本都在 searchFull 和 searchQuiesce 里
+    threadsInit(1);
+    Search.nMaxDepth = nDepth;
+    Search.nMaxTime = 0;
+    Search.nClockTime = 0;
+    Search.nMaxNodes = 0;
+    Search.bStop = false;
+    for (i = 0; i < nFens; i++) {
+        fromFen(&pos, benchFens[i]);
+        hashClear();
+        ioctl(fdAccess, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fdAccess, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        searchMain();
+        ioctl(fdAccess, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(fdAccess, &nAccess, sizeof(nAccess)) != sizeof(nAccess) ||
+            read(fdMiss, &nMiss, sizeof(nMiss)) != sizeof(nMiss)) {
+            nAccess = nMiss = 0;
+        }
+        nNodes = Search.nNodes;
+        nTotalNodes += nNodes;
+        nTotalAccess += nAccess;
+        nTotalMiss += nMiss;
+        printf("%s nodes %lld loads %lld misses %lld misses/node %.2f miss rate %.3f%%\n", benchFens[i],
+               (long long)nNodes, (long long)nAccess, (long long)nMiss,
+               (double)nMiss / (nNodes > 0 ? nNodes : 1), nMiss * 100.0 / (nAccess > 0 ? nAccess : 1));
+    }
+    printf("total nodes %lld loads %lld misses %lld misses/node %.2f miss rate %.3f%%\n",
+           (long long)nTotalNodes, (long long)nTotalAccess, (long long)nTotalMiss,
+           (double)nTotalMiss / (nTotalNodes > 0 ? nTotalNodes : 1),
+           nTotalMiss * 100.0 / (nTotalAccess > 0 ? nTotalAccess : 1));
+    fflush(stdout);
+    close(fdMiss);
+    close(fdAccess);
+#else
+    (void)nDepth;
+    printf("L1D counters not available\n");
+    fflush(stdout);
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef LVENW_BENCH_H
+#define LVENW_BENCH_H
+
+// 搜索的性能测试
+
+#include "engine.h"
+
+// 按当前的搜索选项把几个测试局面搜索到 nDepth 层，输出每个局面和总的节点数、用时
+void benchSearch(int nDepth);
+
+// 用 1/2/4/8/16/32 个线程把几个测试局面搜索到 nDepth 层，输出用时和相对单线程的加速比
+void benchThreads(int nDepth);
+
+// 从测试局面随机走棋得到 nPositions 个局面，检查惰性评价和完整评价相对随机窗口的结果是否一致，
+// 输出后两层分值的最大值(余量的下限)、各层提前返回的比例和每秒评价次数
+void benchEval(int nPositions);
+
+#ifdef USE_NNUE
+// 从测试局面随机走棋得到 nPositions 个局面，检查增量更新的累加器是否和重算的一样，
+// 输出增量更新后、重算累加器后的网络评价和原来的评价每秒的次数；没有读入权重时用随机权重
+void benchNnue(int nPositions);
+#endif
+
+// 单线程把几个测试局面搜索到 nDepth 层，用 perf_event_open 统计一级数据缓存的读访问和缺失次数，
+// 只支持 Linux，比较默认布局和 COMPACT_TABLES 布局用
+void benchCache(int nDepth);
+
+#endif
@@ -0,0 +1,161 @@
+#include "engine.h"
+
+#ifdef USE_BITBOARD
+
+unsigned char squareIndex[256];
+unsigned char squareId[90];
+bitboard squareBB[90];
+bitboard allSquares;        // 全部 90 个格子
+
+// 帅(将)、仕(士)、兵(卒)的走法，只和所在的格子有关
+bitboard kingMoves[90];
+bitboard advisorMoves[90];
+bitboard pawnMoves[2][90];
+
+// 马和相(象)的走法，下标的低 4 位表示 4 个马腿(象眼)是否有子
+bitboard knightMoves[90][16];
+bitboard bishopMoves[2][90][16];
+
+// 在位棋盘中加入一个格子，格子不在棋盘上就忽略
+bitboard addSquare(bitboard bb, int id) {
+    return IN_BOARD(id) ? BB_OR(bb, squareBB[squareIndex[id]]) : bb;
+}
+
+void initBitboard(void) {
+    int i, j, k, n, id, idDst, side;
+
+    // 1. 格子编号
+    memset(squareIndex, 0XFF, 256);
+    n = 0;
+    for (id = 0; id < 256; id++) {
+        if (IN_BOARD(id)) {
+            squareIndex[id] = (unsigned char)n;
+            squareId[n] = (unsigned char)id;
+            squareBB[n] = n < 64 ? BB_MAKE(1ULL << n, 0) : BB_MAKE(0, 1ULL << (n - 64));
+            n++;
+        }
+    }
+    allSquares = BB_MAKE(~0ULL, (1ULL << 26) - 1);
+
+    // 2. 只和格子有关的走法，以及马腿、象眼的每种组合
+    for (n = 0; n < 90; n++) {
+        id = squareId[n];
+        kingMoves[n] = advisorMoves[n] = BB_ZERO();
+        for (i = 0; i < 4; i++) {
+            if (IN_FORT(id + kingDelta[i])) {
+                kingMoves[n] = addSquare(kingMoves[n], id + kingDelta[i]);
+            }
+            if (IN_FORT(id + advisorDelta[i])) {
+                advisorMoves[n] = addSquare(advisorMoves[n], id + advisorDelta[i]);
+            }
+        }
+        for (side = 0; side < 2; side++) {
+            pawnMoves[side][n] = addSquare(BB_ZERO(), SQUARE_FORWARD(id, side));
+            if (AWAY_HALF(id, side)) {
+                pawnMoves[side][n] = addSquare(pawnMoves[side][n], id - 1);
+                pawnMoves[side][n] = addSquare(pawnMoves[side][n], id + 1);
+            }
+        }
+        for (k = 0; k < 16; k++) {
+            knightMoves[n][k] = BB_ZERO();
+            for (i = 0; i < 4; i++) {
+                if ((k & (1 << i)) != 0) {
+                    continue;
+                }
+                for (j = 0; j < 2; j++) {
+                    knightMoves[n][k] = addSquare(knightMoves[n][k], id + knightDelta[i][j]);
+                }
+            }
+            for (side = 0; side < 2; side++) {
+                bishopMoves[side][n][k] = BB_ZERO();
+                for (i = 0; i < 4; i++) {
+                    idDst = id + advisorDelta[i];
+                    if ((k & (1 << i)) != 0 || !IN_BOARD(idDst) || !HOME_HALF(idDst, side)) {
+                        continue;
+                    }
+                    bishopMoves[side][n][k] = addSquare(bishopMoves[side][n][k],
+                                                        idDst + advisorDelta[i]);
+                }
+            }
+        }
+    }
+}
+
+// 把位棋盘中的每个格子都作为终点生成走法
+inline int serializeMoves(bitboard bb, int idSrc, int* mvs) {
+    int n = 0;
+    uint64_t lo = BB_LOW(bb), hi = BB_HIGH(bb);
+    while (lo != 0) {
+        mvs[n++] = MOVE(idSrc, squareId[LSB(lo)]);
+        lo &= lo - 1;
+    }
+    while (hi != 0) {
+        mvs[n++] = MOVE(idSrc, squareId[64 + LSB(hi)]);
+        hi &= hi - 1;
+    }
+    return n;
+}
+
+// 四个方向上相邻的格子是否有子，第 i 位对应 lpDelta[i]
+inline int neighbours(positionStruct* pos, int id, const char* lpDelta) {
+    return (pos->curboard[id + lpDelta[0]] != 0) | ((pos->curboard[id + lpDelta[1]] != 0) << 1) |
+           ((pos->curboard[id + lpDelta[2]] != 0) << 2) | ((pos->curboard[id + lpDelta[3]] != 0) << 3);
+}
+
+// 生成所有走法
+int generateMoves(positionStruct* pos, int* mvs, int nMode) {
+    int k, n, nGenMoves, idSrc, x, y, sideMask, pcOppSide, side;
+    bitboard target;
+
+    nGenMoves = 0;
+    side = pos->blackPlayer;
+    sideMask = SIDE_TAG(side);
+    pcOppSide = OPP_SIDE_TAG(side);
+    // 终点的范围：吃子走法是对方棋子，不吃子走法是空格，全部走法是本方棋子以外的格子
+    if (nMode == GEN_CAPTURE) {
+        target = pos->occSide[1 - side];
+    }
+    else {
+        target = BB_ANDNOT(allSquares, pos->occSide[side]);
+        if (nMode == GEN_QUIET) {
+            target = BB_ANDNOT(target, pos->occSide[1 - side]);
+        }
+    }
+    for (k = 0; k < pos->nPieces[side]; k++) {
+        idSrc = pos->pieceList[side][k];
+        n = squareIndex[idSrc];
+        switch (pos->curboard[idSrc] - sideMask) {
+        case PIECE_KING:
+            nGenMoves += serializeMoves(BB_AND(kingMoves[n], target), idSrc, mvs + nGenMoves);
+            break;
+        case PIECE_ADVISOR:
+            nGenMoves += serializeMoves(BB_AND(advisorMoves[n], target), idSrc, mvs + nGenMoves);
+            break;
+        case PIECE_BISHOP:
+            nGenMoves += serializeMoves(BB_AND(bishopMoves[side][n][neighbours(pos, idSrc, advisorDelta)],
+                                               target), idSrc, mvs + nGenMoves);
+            break;
+        case PIECE_KNIGHT:
+            nGenMoves += serializeMoves(BB_AND(knightMoves[n][neighbours(pos, idSrc, kingDelta)],
+                                               target), idSrc, mvs + nGenMoves);
+            break;
+        case PIECE_ROOK:
+        case PIECE_CANNON:
+            x = X(idSrc);
+            y = Y(idSrc);
+            nGenMoves += lineMovesGen(pos, &rankMoves[x - FILE_LEFT][pos->rankOcc[y]],
+                                      pos->curboard[idSrc] - sideMask == PIECE_CANNON, idSrc,
+                                      COORD_XY(FILE_LEFT, y), 1, pcOppSide, nMode, mvs + nGenMoves);
+            nGenMoves += lineMovesGen(pos, &fileMoves[y - RANK_TOP][pos->fileOcc[x]],
+                                      pos->curboard[idSrc] - sideMask == PIECE_CANNON, idSrc,
+                                      COORD_XY(x, RANK_TOP), 16, pcOppSide, nMode, mvs + nGenMoves);
+            break;
+        case PIECE_PAWN:
+            nGenMoves += serializeMoves(BB_AND(pawnMoves[side][n], target), idSrc, mvs + nGenMoves);
+            break;
+        }
+    }
+    return nGenMoves;
+}
+
+#endif
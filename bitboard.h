@@ -0,0 +1,100 @@
+#ifndef LVENW_BITBOARD_H
+#define LVENW_BITBOARD_H
+
+// 位棋盘后端：编译时定义 USE_BITBOARD 启用，用来替换 engine.cpp 中逐个方向扫描的
+// generateMoves。棋盘的 90 个格子按 "(行 - RANK_TOP) * 9 + (列 - FILE_LEFT)"
+// 编号，放在一个 128 位的 SSE2 寄存器中；车、炮和不用位棋盘时一样按行列占位查表。
+
+#include <stdint.h>
+
+#if (defined(__SSE2__) && defined(__x86_64__)) || defined(_M_X64)
+#include <emmintrin.h>
+#define BITBOARD_SSE2
+#endif
+
+#ifdef BITBOARD_SSE2
+typedef __m128i bitboard;   // 低 64 位是第 0-63 格，高 64 位的低 26 位是第 64-89 格
+#else
+typedef struct bitboard {
+    uint64_t lo, hi;
+} bitboard;
+#endif
+
+inline bitboard BB_AND(bitboard a, bitboard b) {
+#ifdef BITBOARD_SSE2
+    return _mm_and_si128(a, b);
+#else
+    bitboard c = { a.lo & b.lo, a.hi & b.hi };
+    return c;
+#endif
+}
+
+// a & ~b
+inline bitboard BB_ANDNOT(bitboard a, bitboard b) {
+#ifdef BITBOARD_SSE2
+    return _mm_andnot_si128(b, a);
+#else
+    bitboard c = { a.lo & ~b.lo, a.hi & ~b.hi };
+    return c;
+#endif
+}
+
+inline bitboard BB_OR(bitboard a, bitboard b) {
+#ifdef BITBOARD_SSE2
+    return _mm_or_si128(a, b);
+#else
+    bitboard c = { a.lo | b.lo, a.hi | b.hi };
+    return c;
+#endif
+}
+
+inline bitboard BB_XOR(bitboard a, bitboard b) {
+#ifdef BITBOARD_SSE2
+    return _mm_xor_si128(a, b);
+#else
+    bitboard c = { a.lo ^ b.lo, a.hi ^ b.hi };
+    return c;
+#endif
+}
+
+inline bitboard BB_ZERO(void) {
+#ifdef BITBOARD_SSE2
+    return _mm_setzero_si128();
+#else
+    bitboard c = { 0, 0 };
+    return c;
+#endif
+}
+
+inline bitboard BB_MAKE(uint64_t lo, uint64_t hi) {
+#ifdef BITBOARD_SSE2
+    return _mm_set_epi64x((long long)hi, (long long)lo);
+#else
+    bitboard c = { lo, hi };
+    return c;
+#endif
+}
+
+inline uint64_t BB_LOW(bitboard a) {
+#ifdef BITBOARD_SSE2
+    return (uint64_t)_mm_cvtsi128_si64(a);
+#else
+    return a.lo;
+#endif
+}
+
+inline uint64_t BB_HIGH(bitboard a) {
+#ifdef BITBOARD_SSE2
+    return (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a));
+#else
+    return a.hi;
+#endif
+}
+
+extern unsigned char squareIndex[256];  // 格子在位棋盘中的编号，棋盘外是 0XFF
+extern unsigned char squareId[90];      // 位棋盘编号对应的格子
+extern bitboard squareBB[90];           // 只有一个格子的位棋盘
+
+void initBitboard(void);
+
+#endif
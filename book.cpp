@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include "book.h"
+#include "mapfile.h"
+
+// 打开的开局库
+struct {
+    mappedFile file;            // 映射到内存的开局库文件
+    const bookItem* items;      // 文件内容
+    int64_t nItems;             // 项数
+    uint64_t nSeed;             // 随机选择走法用的种子
+} Book;
+
+bool bookOpen(const char* szFile) {
+    bookClose();
+    if (!mapFileOpen(&Book.file, szFile)) {
+        return false;
+    }
+    if (Book.file.nSize % sizeof(bookItem) != 0) {
+        bookClose();
+        return false;
+    }
+    Book.items = (const bookItem*)Book.file.lpData;
+    Book.nItems = (int64_t)(Book.file.nSize / sizeof(bookItem));
+    Book.nSeed = (uint64_t)searchClock();
+    return true;
+}
+
+void bookClose(void) {
+    mapFileClose(&Book.file);
+    Book.items = NULL;
+    Book.nItems = 0;
+}
+
+// 镜像局面的 Zobrist 键值
+uint64_t mirrorZobrist(positionStruct* pos) {
+    int side, k, id;
+    uint64_t key = pos->blackPlayer ? Zobrist.player : 0;
+    for (side = 0; side < 2; side++) {
+        for (k = 0; k < pos->nPieces[side]; k++) {
+            id = pos->pieceList[side][k];
+            key ^= Zobrist.table[ZOBRIST_INDEX(pos->curboard[id])][MIRROR_SQUARE(id)];
+        }
+    }
+    return key;
+}
+
+// 走法是否完全合法：合理，并且走完不被将军
+bool bookLegal(positionStruct* pos, int mv) {
+    int pcCaptured;
+    if (!legalMove(pos, mv) || !makeMove(pos, mv, &pcCaptured)) {
+        return false;
+    }
+    undoMakeMove(pos, mv, pcCaptured);
+    return true;
+}
+
+// 二分查找键值为 key 的项，把其中合法的走法加入 mvs，bMirror 表示要把走法镜像回来
+int bookSearch(positionStruct* pos, uint64_t key, bool bMirror, int* mvs, int* vls, int n) {
+    int64_t nLow = 0, nHigh = Book.nItems, nMid;
+    int mv;
+    // 1. 找第一个键值不小于 key 的项
+    while (nLow < nHigh) {
+        nMid = (nLow + nHigh) / 2;
+        if (Book.items[nMid].key < key) {
+            nLow = nMid + 1;
+        }
+        else {
+            nHigh = nMid;
+        }
+    }
+    // 2. 逐个检查键值相同的项，键值冲突或者文件损坏都可能给出不合法的走法
+    for (; nLow < Book.nItems && Book.items[nLow].key == key && n < MAX_GEN_MOVES; nLow++) {
+        mv = bMirror ? MIRROR_MOVE(Book.items[nLow].mv) : Book.items[nLow].mv;
+        if (Book.items[nLow].weight > 0 && bookLegal(pos, mv)) {
+            mvs[n] = mv;
+            vls[n] = Book.items[nLow].weight;
+            n++;
+        }
+    }
+    return n;
+}
+
+int bookProbe(positionStruct* pos) {
+    int i, n, nTotal, nRandom;
+    int mvs[MAX_GEN_MOVES], vls[MAX_GEN_MOVES];
+    uint64_t keyMirror;
+
+    if (Book.items == NULL) {
+        return 0;
+    }
+    // 1. 查当前局面和镜像局面，对称的局面只查一次
+    n = bookSearch(pos, pos->zobrist, false, mvs, vls, 0);
+    keyMirror = mirrorZobrist(pos);
+    if (keyMirror != pos->zobrist) {
+        n = bookSearch(pos, keyMirror, true, mvs, vls, n);
+    }
+    if (n == 0) {
+        return 0;
+    }
+    // 2. 按权重随机选一个走法
+    nTotal = 0;
+    for (i = 0; i < n; i++) {
+        nTotal += vls[i];
+    }
+    Book.nSeed = Book.nSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    nRandom = (int)((Book.nSeed >> 33) % (uint64_t)nTotal);
+    for (i = 0; i < n - 1; i++) {
+        nRandom -= vls[i];
+        if (nRandom < 0) {
+            break;
+        }
+    }
+    return mvs[i];
+}
+
+// 生成开局库时按键值和走法排序
+int compareBookItem(const void* p1, const void* p2) {
+    const bookItem* lp1 = (const bookItem*)p1;
+    const bookItem* lp2 = (const bookItem*)p2;
+    if (lp1->key != lp2->key) {
+        return lp1->key < lp2->key ? -1 : 1;
+    }
+    return (int)lp1->mv - (int)lp2->mv;
+}
+
+bool bookMake(const char* szTextFile, const char* szBookFile) {
+    char szLine[8192];
+    const char* p;
+    int mv, pcCaptured, nLine;
+    int64_t i, n, nItems, nMaxItems;
+    uint64_t key, keyMirror;
+    bookItem* items;
+    bookItem* itemsNew;
+    FILE* fp;
+    positionStruct posBook;
+
+    fp = fopen(szTextFile, "r");
+    if (fp == NULL) {
+        printf("cannot open %s\n", szTextFile);
+        return false;
+    }
+    nItems = 0;
+    nMaxItems = 1024;
+    items = (bookItem*)malloc((size_t)nMaxItems * sizeof(bookItem));
+
+    // 1. 逐行走棋，每走一步就记录一项，镜像局面键值更小时记录镜像局面和镜像走法
+    nLine = 0;
+    while (items != NULL && fgets(szLine, sizeof(szLine), fp) != NULL) {
+        nLine++;
+        p = szLine;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '#') {
+            continue;
+        }
+        startup(&posBook);
+        while ((mv = strToMove(p)) != 0) {
+            if (!legalMove(&posBook, mv) || !makeMove(&posBook, mv, &pcCaptured)) {
+                printf("line %d: illegal move %.4s\n", nLine, p);
+                break;
+            }
+            undoMakeMove(&posBook, mv, pcCaptured);
+            key = posBook.zobrist;
+            keyMirror = mirrorZobrist(&posBook);
+            if (nItems == nMaxItems) {
+                nMaxItems *= 2;
+                itemsNew = (bookItem*)realloc(items, (size_t)nMaxItems * sizeof(bookItem));
+                if (itemsNew == NULL) {
+                    free(items);
+                }
+                items = itemsNew;
+                if (items == NULL) {
+                    break;
+                }
+            }
+            items[nItems].key = keyMirror < key ? keyMirror : key;
+            items[nItems].mv = (uint16_t)(keyMirror < key ? MIRROR_MOVE(mv) : mv);
+            items[nItems].weight = 1;
+            items[nItems].reserved = 0;
+            nItems++;
+            makeMove(&posBook, mv, &pcCaptured);
+            // 和 ucci 的 position 指令一样，吃子或者历史走法栈太长时从头记录，很长的行也不会越界
+            if (pcCaptured != 0 || posBook.nMoveNum > MAX_MOVE_NUM / 2) {
+                setIrreversible(&posBook);
+            }
+            p += 4;
+            while (*p == ' ' || *p == '\t') {
+                p++;
+            }
+        }
+    }
+    fclose(fp);
+    if (items == NULL) {
+        printf("out of memory\n");
+        return false;
+    }
+
+    // 2. 排序，合并相同的项，权重累加
+    qsort(items, (size_t)nItems, sizeof(bookItem), compareBookItem);
+    n = 0;
+    for (i = 0; i < nItems; i++) {
+        if (n > 0 && items[n - 1].key == items[i].key && items[n - 1].mv == items[i].mv) {
+            if (items[n - 1].weight < 0XFFFF) {
+                items[n - 1].weight++;
+            }
+        }
+        else {
+            items[n++] = items[i];
+        }
+    }
+
+    // 3. 写文件
+    fp = fopen(szBookFile, "wb");
+    if (fp == NULL || fwrite(items, sizeof(bookItem), (size_t)n, fp) != (size_t)n) {
+        printf("cannot write %s\n", szBookFile);
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        free(items);
+        return false;
+    }
+    fclose(fp);
+    free(items);
+    printf("%lld moves, %lld items\n", (long long)nItems, (long long)n);
+    return true;
+}
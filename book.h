@@ -0,0 +1,30 @@
+#ifndef LVENW_BOOK_H
+#define LVENW_BOOK_H
+
+// 开局库：按局面键值排好序的 (键值, 走法, 权重) 数组，用内存映射打开，二分查找。
+// 左右对称的两个局面只保存键值小的一个，查找时当前局面和它的镜像局面都要查，
+// 所以开局库文件只有一半大。文件按本机字节序保存
+
+#include "engine.h"
+
+#define BOOK_FILE       "book.bin"          // 默认的开局库文件
+
+// 开局库的一项，16 字节
+typedef struct bookItem {
+    uint64_t key;               // 局面的 Zobrist 键值
+    uint16_t mv;                // 走法
+    uint16_t weight;            // 权重，同一局面的走法按权重随机选择
+    uint32_t reserved;
+} bookItem;
+
+// 打开开局库文件，失败返回 false，原来打开的开局库总是先关闭
+bool bookOpen(const char* szFile);
+void bookClose(void);
+
+// 查找开局库，返回按权重随机选出的合法走法，没有就返回 0
+int bookProbe(positionStruct* pos);
+
+// 由文本文件生成开局库，每行是从初始局面开始的一串 ICCS 走法，'#' 开头的行是注释
+bool bookMake(const char* szTextFile, const char* szBookFile);
+
+#endif
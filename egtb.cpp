@@ -0,0 +1,971 @@
+#include <stdio.h>
+#include "egtb.h"
+#include "mapfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// 残局库的一项是一个字节，都是相对走子方的结果：
+// 0 和棋，1-126 胜、值是到杀棋的步数，128-254 负、值减 128 是到被杀的步数，
+// 255 是不合法的局面，只在生成时出现，写文件时当作任意值
+#define EGTB_DRAW       0
+#define EGTB_LOSS       128
+#define EGTB_INVALID    255
+#define EGTB_MAX_DTM    126                 // 最多算到多少步杀，超过的当作和棋
+#define EGTB_BLOCK      1024                // 压缩块的项数，查一项最多解压一块
+#define EGTB_VERSION    2
+
+// 压缩的符号：0-254 是一项的值，EGTB_RUN_BASE + c 表示前一个值再重复 n 次，c 是 n 的最高位，
+// 后面跟着 n 的低 c 位。一块里重复不超过 EGTB_BLOCK - 1 次，所以有 EGTB_RUN_CLASSES 个类别
+#define EGTB_RUN_BASE       256
+#define EGTB_RUN_CLASSES    10
+#define EGTB_SYMBOLS        (EGTB_RUN_BASE + EGTB_RUN_CLASSES)
+#define EGTB_MAX_CODE       24              // Huffman 编码的最大长度
+
+// 文件头，后面是 nBlocks + 1 个 uint32_t 的块偏移(相对压缩数据的开头)，然后是压缩数据。
+// 两个走子方的表连在一起分块，每块是从字节边界开始的一串 Huffman 编码的符号，整个文件共用一套编码，
+// 由每个符号的编码长度(0 表示不出现)按范式 Huffman 编码的规则确定
+typedef struct egtbHeader {
+    char szMagic[4];            // "LVTB"
+    uint32_t nVersion;
+    uint32_t nEntries;          // 每个走子方的局面数
+    uint32_t nBlocks;           // 压缩块数
+    uint32_t nMaxDtm;           // 表中最长的杀棋步数
+    char szMaterial[16];        // 子力组合
+    unsigned char nCodeLen[EGTB_SYMBOLS];  // 每个符号的编码长度
+} egtbHeader;
+
+// 一组相同的棋子
+typedef struct egtbGroup {
+    int type;                   // 棋子，红方或黑方
+    int nCount;                 // 个数
+    uint32_t nRadix;            // 摆法数，即 C(能放的格子数, 个数)
+} egtbGroup;
+
+// 一个残局库
+typedef struct egtbTable {
+    uint64_t nSig;              // 子力组合的编码，见 materialSig
+    char szMaterial[16];
+    int nGroups;
+    egtbGroup groups[2 * 7];    // 先红方后黑方，帅(将)在前，其余按棋子编号
+    uint32_t nEntries;          // 每个走子方的局面数
+    int nMaxDtm;
+    unsigned char* lpValues;    // 生成时的表，2 * nEntries 项，不压缩
+    mappedFile file;            // 打开的残局库文件
+    const uint32_t* lpOffsets;
+    const unsigned char* lpData;
+    uint16_t nCodeCount[EGTB_MAX_CODE + 1];  // 每种长度的编码个数，解码用
+    uint16_t wCodeSymbol[EGTB_SYMBOLS];      // 按编码从小到大排列的符号
+} egtbTable;
+
+struct {
+    egtbTable* tables[EGTB_MAX_TABLES];
+    int nTables;
+    int nMaxPieces;             // 残局库中最多的棋子数(算上帅、将)，超过就不用查
+    bool bInit;                 // 格子表和组合数表是否已经初始化
+    int64_t nMadeEntries;       // egtbMake 这一次生成的局面数和文件的总字节数，输出压缩率用
+    int64_t nMadeBytes;
+} Egtb;
+
+// 每种棋子能放的格子，按格子从小到大排列，以及格子在其中的序号(不能放是 0XFF)
+unsigned char egtbSquares[2][7][90];
+int egtbSquareNum[2][7];
+unsigned char egtbSquareIndex[2][7][256];
+
+// 组合数 C(n, k)
+uint32_t egtbComb[91][EGTB_MAX_PIECES + 1];
+
+// 判断 SIDE_WEIGHT 用的棋子分量：仕、相 1，马、炮 4，车 9，兵 2
+const int egtbWeight[7] = { 0, 1, 1, 4, 9, 4, 2 };
+
+// 子力组合的编码：每方每种棋子(帅、将除外)的个数占 3 位，红方在低 18 位
+inline int SIG_COUNT(uint64_t nSig, int side, int pt) {
+    return (int)((nSig >> (18 * side + 3 * (pt - 1))) & 7);
+}
+
+inline uint64_t SIG_FLIP(uint64_t nSig) {
+    return (nSig >> 18) | ((nSig & 0X3FFFF) << 18);
+}
+
+inline int SIDE_WEIGHT(uint64_t nSig, int side) {
+    int pt, n = 0;
+    for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+        n += egtbWeight[pt] * SIG_COUNT(nSig, side, pt);
+    }
+    return n;
+}
+
+// 较强的一方是红方的编码才是残局库使用的编码
+inline bool SIG_CANONICAL(uint64_t nSig) {
+    int vlRed = SIDE_WEIGHT(nSig, 0), vlBlack = SIDE_WEIGHT(nSig, 1);
+    return vlRed > vlBlack || (vlRed == vlBlack && (nSig & 0X3FFFF) >= (nSig >> 18));
+}
+
+// 有没有车、马、炮、兵
+inline bool SIG_ATTACK(uint64_t nSig) {
+    int side, pt;
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_KNIGHT; pt <= PIECE_PAWN; pt++) {
+            if (SIG_COUNT(nSig, side, pt) != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 局面的子力组合编码
+uint64_t materialSig(positionStruct* pos) {
+    int side, k, pt;
+    uint64_t nSig = 0;
+    for (side = 0; side < 2; side++) {
+        for (k = 0; k < pos->nPieces[side]; k++) {
+            pt = pos->curboard[pos->pieceList[side][k]] & 7;
+            if (pt != PIECE_KING) {
+                nSig += (uint64_t)1 << (18 * side + 3 * (pt - 1));
+            }
+        }
+    }
+    return nSig;
+}
+
+// 由子力组合的名称得到编码，格式不对返回 false
+bool parseMaterial(const char* szMaterial, uint64_t* lpSig) {
+    int side = -1, pt;
+    const char* p;
+    *lpSig = 0;
+    for (p = szMaterial; *p != '\0'; p++) {
+        if (*p == 'K' || *p == 'k') {
+            if (++side > 1) {
+                return false;
+            }
+            continue;
+        }
+        for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+            if (*p == "KABNRCP"[pt] || *p == "kabnrcp"[pt]) {
+                break;
+            }
+        }
+        if (side < 0 || pt > PIECE_PAWN || SIG_COUNT(*lpSig, side, pt) == 7) {
+            return false;
+        }
+        *lpSig += (uint64_t)1 << (18 * side + 3 * (pt - 1));
+    }
+    return side == 1;
+}
+
+// 由编码得到子力组合的名称
+void materialName(uint64_t nSig, char* szMaterial) {
+    int side, pt, i;
+    for (side = 0; side < 2; side++) {
+        *szMaterial++ = 'K';
+        for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+            for (i = 0; i < SIG_COUNT(nSig, side, pt); i++) {
+                *szMaterial++ = "KABNRCP"[pt];
+            }
+        }
+    }
+    *szMaterial = '\0';
+}
+
+// 初始化每种棋子能放的格子：从初始位置出发，按棋子的走法能到达的格子，车、马、炮是全部格子
+void initEgtbSquares(void) {
+    int side, pt, i, n, id, idDst, nHead;
+    bool bReached[256];
+    unsigned char queue[256];
+
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_KING; pt <= PIECE_PAWN; pt++) {
+            memset(bReached, 0, sizeof(bReached));
+            n = 0;
+            for (id = 0; id < 256; id++) {
+                if (pt == PIECE_KNIGHT || pt == PIECE_ROOK || pt == PIECE_CANNON ?
+                    IN_BOARD(id) : boardStartup[id] == SIDE_TAG(side) + pt) {
+                    bReached[id] = true;
+                    queue[n++] = (unsigned char)id;
+                }
+            }
+            for (nHead = 0; nHead < n; nHead++) {
+                id = queue[nHead];
+                for (i = 0; i < 4; i++) {
+                    switch (pt) {
+                    case PIECE_KING:
+                        idDst = IN_FORT(id + kingDelta[i]) ? id + kingDelta[i] : 0;
+                        break;
+                    case PIECE_ADVISOR:
+                        idDst = IN_FORT(id + advisorDelta[i]) ? id + advisorDelta[i] : 0;
+                        break;
+                    case PIECE_BISHOP:
+                        idDst = id + advisorDelta[i] * 2;
+                        idDst = IN_BOARD(idDst) && HOME_HALF(idDst, side) ? idDst : 0;
+                        break;
+                    case PIECE_PAWN:
+                        // 兵(卒)：前进，过河后可以左右走
+                        idDst = i == 0 ? SQUARE_FORWARD(id, side) :
+                                i == 1 && AWAY_HALF(id, side) ? id - 1 :
+                                i == 2 && AWAY_HALF(id, side) ? id + 1 : 0;
+                        idDst = IN_BOARD(idDst) ? idDst : 0;
+                        break;
+                    default:
+                        idDst = 0;
+                        break;
+                    }
+                    if (idDst != 0 && !bReached[idDst]) {
+                        bReached[idDst] = true;
+                        queue[n++] = (unsigned char)idDst;
+                    }
+                }
+            }
+            memset(egtbSquareIndex[side][pt], 0XFF, 256);
+            egtbSquareNum[side][pt] = 0;
+            for (id = 0; id < 256; id++) {
+                if (bReached[id]) {
+                    egtbSquareIndex[side][pt][id] = (unsigned char)egtbSquareNum[side][pt];
+                    egtbSquares[side][pt][egtbSquareNum[side][pt]++] = (unsigned char)id;
+                }
+            }
+        }
+    }
+    for (n = 0; n <= 90; n++) {
+        egtbComb[n][0] = 1;
+        for (i = 1; i <= EGTB_MAX_PIECES; i++) {
+            egtbComb[n][i] = n == 0 ? 0 : egtbComb[n - 1][i - 1] + egtbComb[n - 1][i];
+        }
+    }
+    Egtb.bInit = true;
+}
+
+// 按子力组合分好棋子组，算出局面数，局面太多返回 false
+bool setupTable(egtbTable* tb, uint64_t nSig) {
+    int side, pt, n;
+    uint64_t nEntries = 1;
+    egtbGroup* g;
+
+    tb->nSig = nSig;
+    materialName(nSig, tb->szMaterial);
+    tb->nGroups = 0;
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_KING; pt <= PIECE_PAWN; pt++) {
+            n = pt == PIECE_KING ? 1 : SIG_COUNT(nSig, side, pt);
+            if (n == 0) {
+                continue;
+            }
+            if (n > EGTB_MAX_PIECES) {
+                return false;
+            }
+            g = &tb->groups[tb->nGroups++];
+            g->type = SIDE_TAG(side) + pt;
+            g->nCount = n;
+            g->nRadix = egtbComb[egtbSquareNum[side][pt]][n];
+            nEntries *= g->nRadix;
+        }
+    }
+    if (nEntries > 0X7FFFFFFF) {
+        return false;
+    }
+    tb->nEntries = (uint32_t)nEntries;
+    return true;
+}
+
+// 局面在表中的序号，bFlip 表示把棋盘旋转 180 度并交换双方后再查
+bool positionIndex(egtbTable* tb, positionStruct* pos, bool bFlip, uint32_t* lpIndex) {
+    int i, j, k, n, side, pt, sq, id;
+    int sqs[EGTB_MAX_PIECES];
+    uint32_t nIndex = 0, nRank;
+    egtbGroup* g;
+
+    for (i = 0; i < tb->nGroups; i++) {
+        g = &tb->groups[i];
+        side = SIDE_INDEX(g->type);
+        pt = g->type & 7;
+        // 1. 找出这一组棋子的格子序号，按从小到大插入
+        n = 0;
+        for (k = 0; k < pos->nPieces[bFlip ? 1 - side : side]; k++) {
+            id = pos->pieceList[bFlip ? 1 - side : side][k];
+            if ((pos->curboard[id] & 7) != pt) {
+                continue;
+            }
+            sq = egtbSquareIndex[side][pt][bFlip ? SQUARE_FLIP(id) : id];
+            if (sq == 0XFF || n == g->nCount) {
+                return false;
+            }
+            for (j = n; j > 0 && sqs[j - 1] > sq; j--) {
+                sqs[j] = sqs[j - 1];
+            }
+            sqs[j] = sq;
+            n++;
+        }
+        if (n != g->nCount) {
+            return false;
+        }
+        // 2. 组合的序号：C(sq1, 1) + C(sq2, 2) + ...
+        nRank = 0;
+        for (j = 0; j < n; j++) {
+            nRank += egtbComb[sqs[j]][j + 1];
+        }
+        nIndex = nIndex * g->nRadix + nRank;
+    }
+    *lpIndex = nIndex;
+    return true;
+}
+
+// 由序号摆出局面，棋子重叠返回 false
+bool indexPosition(egtbTable* tb, int stm, uint32_t nIndex, positionStruct* pos) {
+    int i, j, sq, side, pt, id;
+    uint32_t nRank[2 * 7];
+    egtbGroup* g;
+
+    for (i = tb->nGroups - 1; i >= 0; i--) {
+        nRank[i] = nIndex % tb->groups[i].nRadix;
+        nIndex /= tb->groups[i].nRadix;
+    }
+    clearBoard(pos);
+    for (i = 0; i < tb->nGroups; i++) {
+        g = &tb->groups[i];
+        side = SIDE_INDEX(g->type);
+        pt = g->type & 7;
+        sq = egtbSquareNum[side][pt];
+        for (j = g->nCount; j > 0; j--) {
+            // 找最大的 sq，使 C(sq, j) 不超过剩下的序号
+            do {
+                sq--;
+            } while (egtbComb[sq][j] > nRank[i]);
+            nRank[i] -= egtbComb[sq][j];
+            id = egtbSquares[side][pt][sq];
+            if (pos->curboard[id] != 0) {
+                return false;
+            }
+            addPiece(pos, id, g->type);
+        }
+    }
+    if (stm != 0) {
+        changeSide(pos);
+    }
+    return true;
+}
+
+// 压缩块的位流，每个字节从最高位读起
+typedef struct egtbBits {
+    const unsigned char* lp;
+    uint32_t nPos, nEnd;        // 读到的位置和块的长度(位)
+} egtbBits;
+
+// 读 n 位，超出块的结尾返回 -1
+int readBits(egtbBits* bits, int n) {
+    int i, v = 0;
+    if (bits->nPos + n > bits->nEnd) {
+        return -1;
+    }
+    for (i = 0; i < n; i++, bits->nPos++) {
+        v = (v << 1) | ((bits->lp[bits->nPos >> 3] >> (7 - (bits->nPos & 7))) & 1);
+    }
+    return v;
+}
+
+// 按范式 Huffman 编码逐位解码一个符号：同样长度的编码是连续的，比这种长度的第一个编码大多少，
+// 就是这种长度的第几个符号。文件损坏时返回 -1
+int readSymbol(const egtbTable* tb, egtbBits* bits) {
+    int nLen, nBit, nCode = 0, nFirst = 0, nIndex = 0;
+    for (nLen = 1; nLen <= EGTB_MAX_CODE; nLen++) {
+        nBit = readBits(bits, 1);
+        if (nBit < 0) {
+            return -1;
+        }
+        nCode |= nBit;
+        if (nCode - nFirst < tb->nCodeCount[nLen]) {
+            return tb->wCodeSymbol[nIndex + nCode - nFirst];
+        }
+        nIndex += tb->nCodeCount[nLen];
+        nFirst = (nFirst + tb->nCodeCount[nLen]) << 1;
+        nCode <<= 1;
+    }
+    return -1;
+}
+
+// 表中的一项，打开的文件从所在块的开头解码到这一项，文件损坏时当作不合法的局面
+int tableValue(egtbTable* tb, int stm, uint32_t nIndex) {
+    uint64_t k = (uint64_t)stm * tb->nEntries + nIndex;
+    uint32_t nOffset, nPos;
+    int nSymbol, nRun, nValue;
+    egtbBits bits;
+    if (tb->lpValues != NULL) {
+        return tb->lpValues[k];
+    }
+    bits.lp = tb->lpData + tb->lpOffsets[k / EGTB_BLOCK];
+    bits.nPos = 0;
+    bits.nEnd = (tb->lpOffsets[k / EGTB_BLOCK + 1] - tb->lpOffsets[k / EGTB_BLOCK]) * 8;
+    nOffset = (uint32_t)(k % EGTB_BLOCK);
+    nValue = EGTB_INVALID;
+    nPos = 0;
+    for (;;) {
+        nSymbol = readSymbol(tb, &bits);
+        if (nSymbol < 0) {
+            return EGTB_INVALID;
+        }
+        if (nSymbol < EGTB_RUN_BASE) {
+            nValue = nSymbol;
+            nRun = 1;
+        }
+        else {
+            nRun = readBits(&bits, nSymbol - EGTB_RUN_BASE);
+            if (nRun < 0) {
+                return EGTB_INVALID;
+            }
+            nRun |= 1 << (nSymbol - EGTB_RUN_BASE);
+        }
+        if (nOffset < nPos + nRun) {
+            return nValue;
+        }
+        nPos += nRun;
+    }
+}
+
+// 由编码长度得到解码用的表，长度不能构成前缀码时返回 false
+bool setupCodes(egtbTable* tb, const unsigned char* nCodeLen) {
+    int i, nLen, nIndex;
+    int64_t nLeft = 1;
+    memset(tb->nCodeCount, 0, sizeof(tb->nCodeCount));
+    for (i = 0; i < EGTB_SYMBOLS; i++) {
+        if (nCodeLen[i] > EGTB_MAX_CODE) {
+            return false;
+        }
+        tb->nCodeCount[nCodeLen[i]]++;
+    }
+    tb->nCodeCount[0] = 0;
+    for (nLen = 1; nLen <= EGTB_MAX_CODE; nLen++) {
+        nLeft = nLeft * 2 - tb->nCodeCount[nLen];
+        if (nLeft < 0) {
+            return false;
+        }
+    }
+    nIndex = 0;
+    for (nLen = 1; nLen <= EGTB_MAX_CODE; nLen++) {
+        for (i = 0; i < EGTB_SYMBOLS; i++) {
+            if (nCodeLen[i] == nLen) {
+                tb->wCodeSymbol[nIndex++] = (uint16_t)i;
+            }
+        }
+    }
+    return true;
+}
+
+egtbTable* findTable(uint64_t nSig) {
+    int i;
+    for (i = 0; i < Egtb.nTables; i++) {
+        if (Egtb.tables[i]->nSig == nSig) {
+            return Egtb.tables[i];
+        }
+    }
+    return NULL;
+}
+
+// 查局面的结果，得到相对走子方的值；没有进攻子力的组合是和棋；没有残局库返回 false
+bool lookupValue(positionStruct* pos, int* lpValue) {
+    bool bFlip;
+    uint32_t nIndex;
+    egtbTable* tb;
+    uint64_t nSig = materialSig(pos);
+
+    if (!SIG_ATTACK(nSig)) {
+        *lpValue = EGTB_DRAW;
+        return true;
+    }
+    bFlip = !SIG_CANONICAL(nSig);
+    tb = findTable(bFlip ? SIG_FLIP(nSig) : nSig);
+    if (tb == NULL || !positionIndex(tb, pos, bFlip, &nIndex)) {
+        return false;
+    }
+    *lpValue = tableValue(tb, bFlip ? 1 - pos->blackPlayer : pos->blackPlayer, nIndex);
+    return true;
+}
+
+bool egtbProbe(positionStruct* pos, int* vl) {
+    int nValue;
+    if (Egtb.nTables == 0 || pos->nPieces[0] + pos->nPieces[1] > Egtb.nMaxPieces ||
+        !lookupValue(pos, &nValue)) {
+        return false;
+    }
+    // 杀棋分值按距离根节点的步数调整，和搜索中的杀棋分值一致
+    if (nValue == EGTB_DRAW || nValue == EGTB_INVALID) {
+        *vl = 0;
+    }
+    else if (nValue < EGTB_LOSS) {
+        *vl = MATE_VALUE - pos->nDistance - nValue;
+    }
+    else {
+        *vl = pos->nDistance + (nValue - EGTB_LOSS) - MATE_VALUE;
+    }
+    return true;
+}
+
+// 加入一个残局库
+void addTable(egtbTable* tb) {
+    int n = 2;
+    int side, pt;
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+            n += SIG_COUNT(tb->nSig, side, pt);
+        }
+    }
+    Egtb.tables[Egtb.nTables++] = tb;
+    Egtb.nMaxPieces = n > Egtb.nMaxPieces ? n : Egtb.nMaxPieces;
+}
+
+// 打开一个残局库文件，检查文件头和大小
+bool openTable(const char* szFile) {
+    uint32_t i;
+    uint64_t nSig;
+    bool bOk;
+    const egtbHeader* lpHeader;
+    egtbTable* tb;
+
+    if (Egtb.nTables == EGTB_MAX_TABLES) {
+        return false;
+    }
+    tb = (egtbTable*)calloc(1, sizeof(egtbTable));
+    if (tb == NULL) {
+        return false;
+    }
+    if (!mapFileOpen(&tb->file, szFile)) {
+        free(tb);
+        return false;
+    }
+    lpHeader = (const egtbHeader*)tb->file.lpData;
+    if (tb->file.nSize < sizeof(egtbHeader) || memcmp(lpHeader->szMagic, "LVTB", 4) != 0 ||
+        lpHeader->nVersion != EGTB_VERSION || lpHeader->szMaterial[15] != '\0' ||
+        !parseMaterial(lpHeader->szMaterial, &nSig) || !SIG_CANONICAL(nSig) ||
+        findTable(nSig) != NULL || !setupTable(tb, nSig) || !setupCodes(tb, lpHeader->nCodeLen) ||
+        tb->nEntries != lpHeader->nEntries ||
+        lpHeader->nBlocks != ((uint64_t)tb->nEntries * 2 + EGTB_BLOCK - 1) / EGTB_BLOCK ||
+        tb->file.nSize < sizeof(egtbHeader) + (lpHeader->nBlocks + 1) * sizeof(uint32_t)) {
+        mapFileClose(&tb->file);
+        free(tb);
+        return false;
+    }
+    tb->nMaxDtm = (int)lpHeader->nMaxDtm;
+    tb->lpOffsets = (const uint32_t*)(lpHeader + 1);
+    tb->lpData = (const unsigned char*)(tb->lpOffsets + lpHeader->nBlocks + 1);
+    // 块偏移要递增，解码时才不会读到块外面
+    bOk = true;
+    for (i = 0; i < lpHeader->nBlocks; i++) {
+        bOk = bOk && tb->lpOffsets[i] <= tb->lpOffsets[i + 1];
+    }
+    if (!bOk || sizeof(egtbHeader) + (lpHeader->nBlocks + 1) * sizeof(uint32_t) +
+        tb->lpOffsets[lpHeader->nBlocks] != tb->file.nSize) {
+        mapFileClose(&tb->file);
+        free(tb);
+        return false;
+    }
+    addTable(tb);
+    return true;
+}
+
+int egtbInit(const char* szDir) {
+    char szFile[1024];
+    size_t n;
+
+    egtbClose();
+    if (!Egtb.bInit) {
+        initEgtbSquares();
+    }
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE hFind;
+    snprintf(szFile, sizeof(szFile), "%s\\*.egtb", szDir);
+    hFind = FindFirstFileA(szFile, &fd);
+    if (hFind == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    do {
+        snprintf(szFile, sizeof(szFile), "%s\\%s", szDir, fd.cFileName);
+        openTable(szFile);
+    } while (FindNextFileA(hFind, &fd));
+    FindClose(hFind);
+#else
+    DIR* dir;
+    struct dirent* ent;
+    dir = opendir(szDir);
+    if (dir == NULL) {
+        return 0;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        n = strlen(ent->d_name);
+        if (n > 5 && strcmp(ent->d_name + n - 5, ".egtb") == 0) {
+            snprintf(szFile, sizeof(szFile), "%s/%s", szDir, ent->d_name);
+            openTable(szFile);
+        }
+    }
+    closedir(dir);
+#endif
+    (void)n;
+    return Egtb.nTables;
+}
+
+void egtbClose(void) {
+    int i;
+    for (i = 0; i < Egtb.nTables; i++) {
+        mapFileClose(&Egtb.tables[i]->file);
+        free(Egtb.tables[i]->lpValues);
+        free(Egtb.tables[i]);
+    }
+    Egtb.nTables = 0;
+    Egtb.nMaxPieces = 0;
+}
+
+// 按频率算出 Huffman 编码的长度：每次合并频率最小的两个节点，叶子的深度就是编码长度。
+// 最长的编码超过 EGTB_MAX_CODE 时把频率减半(不为 0 的至少是 1)重新算
+void huffmanLengths(const uint32_t* lpFreq, unsigned char* nCodeLen) {
+    int i, j, n, nMin1, nMin2, nMaxLen, nLen;
+    uint64_t nFreq[EGTB_SYMBOLS * 2];
+    int nParent[EGTB_SYMBOLS * 2];
+    bool bActive[EGTB_SYMBOLS * 2];
+
+    for (i = 0; i < EGTB_SYMBOLS; i++) {
+        nFreq[i] = lpFreq[i];
+    }
+    for (;;) {
+        n = EGTB_SYMBOLS;
+        for (i = 0; i < EGTB_SYMBOLS; i++) {
+            bActive[i] = nFreq[i] != 0;
+            nParent[i] = -1;
+        }
+        for (;;) {
+            nMin1 = nMin2 = -1;
+            for (i = 0; i < n; i++) {
+                if (!bActive[i]) {
+                    continue;
+                }
+                if (nMin1 < 0 || nFreq[i] < nFreq[nMin1]) {
+                    nMin2 = nMin1;
+                    nMin1 = i;
+                }
+                else if (nMin2 < 0 || nFreq[i] < nFreq[nMin2]) {
+                    nMin2 = i;
+                }
+            }
+            if (nMin2 < 0) {
+                break;
+            }
+            nFreq[n] = nFreq[nMin1] + nFreq[nMin2];
+            bActive[n] = true;
+            nParent[n] = -1;
+            bActive[nMin1] = bActive[nMin2] = false;
+            nParent[nMin1] = nParent[nMin2] = n;
+            n++;
+        }
+        // 只有一个符号时也要用 1 位的编码
+        nMaxLen = 0;
+        for (i = 0; i < EGTB_SYMBOLS; i++) {
+            nLen = 0;
+            for (j = nParent[i]; j >= 0; j = nParent[j]) {
+                nLen++;
+            }
+            nCodeLen[i] = (unsigned char)(nFreq[i] == 0 ? 0 : nLen == 0 ? 1 : nLen);
+            nMaxLen = nCodeLen[i] > nMaxLen ? nCodeLen[i] : nMaxLen;
+        }
+        if (nMaxLen <= EGTB_MAX_CODE) {
+            return;
+        }
+        for (i = 0; i < EGTB_SYMBOLS; i++) {
+            nFreq[i] = nFreq[i] == 0 ? 0 : (nFreq[i] + 1) / 2;
+        }
+    }
+}
+
+// 按编码长度给每个符号分配范式 Huffman 编码：短的在前，同样长度的按符号顺序连续分配
+void huffmanCodes(const unsigned char* nCodeLen, uint32_t* lpCodes) {
+    int i, nLen;
+    uint32_t nCode = 0;
+    for (nLen = 1; nLen <= EGTB_MAX_CODE; nLen++) {
+        for (i = 0; i < EGTB_SYMBOLS; i++) {
+            if (nCodeLen[i] == nLen) {
+                lpCodes[i] = nCode++;
+            }
+        }
+        nCode <<= 1;
+    }
+}
+
+// 写 n 位，从字节的最高位写起，lpData 要先清零
+inline void writeBits(unsigned char* lpData, uint32_t* lpPos, uint32_t v, int n) {
+    while (n > 0) {
+        n--;
+        lpData[*lpPos >> 3] |= (unsigned char)(((v >> n) & 1) << (7 - (*lpPos & 7)));
+        (*lpPos)++;
+    }
+}
+
+// 把表分块变成符号：每个游程是一个值，游程长于 1 时后面跟着重复的次数，不合法的局面取前一项的值，
+// 让游程更长。lpCodes 为 NULL 时只统计每个符号出现的次数，否则把编码写到 lpData，每块从字节边界开始，
+// 块偏移写到 lpOffsets
+void encodeBlocks(const egtbTable* tb, uint32_t* lpFreq, const uint32_t* lpCodes, const unsigned char* nCodeLen,
+                  unsigned char* lpData, uint32_t* lpOffsets) {
+    uint32_t i, nEnd, nRun, nTotal, nBlocks, nPos;
+    int nSymbol;
+    unsigned char cValue, cLast;
+
+    nTotal = tb->nEntries * 2;
+    nBlocks = (nTotal + EGTB_BLOCK - 1) / EGTB_BLOCK;
+    nPos = 0;
+    cLast = EGTB_DRAW;
+    for (i = 0; i < nTotal; i = nEnd) {
+        if (i % EGTB_BLOCK == 0 && lpCodes != NULL) {
+            nPos = (nPos + 7) / 8 * 8;
+            lpOffsets[i / EGTB_BLOCK] = nPos / 8;
+        }
+        cValue = tb->lpValues[i] == EGTB_INVALID ? cLast : tb->lpValues[i];
+        nEnd = i + 1;
+        while (nEnd < nTotal && nEnd % EGTB_BLOCK != 0 &&
+               (tb->lpValues[nEnd] == cValue || tb->lpValues[nEnd] == EGTB_INVALID)) {
+            nEnd++;
+        }
+        // 值，以及再重复的次数
+        nRun = nEnd - i - 1;
+        nSymbol = EGTB_RUN_BASE;
+        while (nRun >> (nSymbol - EGTB_RUN_BASE + 1) != 0) {
+            nSymbol++;
+        }
+        if (lpCodes == NULL) {
+            lpFreq[cValue]++;
+            lpFreq[nSymbol] += nRun > 0 ? 1 : 0;
+        }
+        else {
+            writeBits(lpData, &nPos, lpCodes[cValue], nCodeLen[cValue]);
+            if (nRun > 0) {
+                writeBits(lpData, &nPos, lpCodes[nSymbol], nCodeLen[nSymbol]);
+                writeBits(lpData, &nPos, nRun, nSymbol - EGTB_RUN_BASE);
+            }
+        }
+        cLast = cValue;
+    }
+    if (lpCodes != NULL) {
+        lpOffsets[nBlocks] = (nPos + 7) / 8;
+    }
+}
+
+// 压缩并写入文件
+bool writeTable(egtbTable* tb, const char* szDir) {
+    char szFile[1024];
+    uint32_t nBlocks, nTotal, nBytes;
+    uint32_t nFreq[EGTB_SYMBOLS];
+    uint32_t nCodes[EGTB_SYMBOLS];
+    uint32_t* lpOffsets;
+    unsigned char* lpData;
+    egtbHeader header;
+    FILE* fp;
+    bool bOk;
+
+    nTotal = tb->nEntries * 2;
+    nBlocks = (nTotal + EGTB_BLOCK - 1) / EGTB_BLOCK;
+    lpOffsets = (uint32_t*)malloc((nBlocks + 1) * sizeof(uint32_t));
+    // 每项最多一个值的编码，再加上每块对齐字节边界的一个字节
+    lpData = (unsigned char*)calloc((size_t)nTotal * ((EGTB_MAX_CODE + 7) / 8) + nBlocks, 1);
+    if (lpOffsets == NULL || lpData == NULL) {
+        free(lpOffsets);
+        free(lpData);
+        return false;
+    }
+
+    // 1. 统计符号的频率，得到整个文件共用的 Huffman 编码，再逐块编码
+    memset(&header, 0, sizeof(header));
+    memset(nFreq, 0, sizeof(nFreq));
+    encodeBlocks(tb, nFreq, NULL, NULL, NULL, NULL);
+    huffmanLengths(nFreq, header.nCodeLen);
+    huffmanCodes(header.nCodeLen, nCodes);
+    encodeBlocks(tb, NULL, nCodes, header.nCodeLen, lpData, lpOffsets);
+
+    // 2. 写文件头、块偏移和压缩数据
+    memcpy(header.szMagic, "LVTB", 4);
+    header.nVersion = EGTB_VERSION;
+    header.nEntries = tb->nEntries;
+    header.nBlocks = nBlocks;
+    header.nMaxDtm = (uint32_t)tb->nMaxDtm;
+    strcpy(header.szMaterial, tb->szMaterial);
+    snprintf(szFile, sizeof(szFile), "%s/%s.egtb", szDir, tb->szMaterial);
+    fp = fopen(szFile, "wb");
+    bOk = fp != NULL && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+          fwrite(lpOffsets, sizeof(uint32_t), nBlocks + 1, fp) == nBlocks + 1 &&
+          fwrite(lpData, 1, lpOffsets[nBlocks], fp) == lpOffsets[nBlocks];
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    nBytes = (uint32_t)(sizeof(header) + (nBlocks + 1) * sizeof(uint32_t) + lpOffsets[nBlocks]);
+    Egtb.nMadeEntries += nTotal;
+    Egtb.nMadeBytes += nBytes;
+    printf("%s: %u positions, %u bytes (%.1f%%), longest mate %d\n", szFile, nTotal, nBytes,
+           nBytes * 100.0 / nTotal, tb->nMaxDtm);
+    fflush(stdout);
+    free(lpOffsets);
+    free(lpData);
+    return bOk;
+}
+
+// 逆推生成一个残局库。先标出不合法的局面和被杀(困毙)的局面，然后第 n 轮：
+// 有走法到达对方负 n - 1 步的局面就是胜 n 步；所有走法都到达对方胜的局面(步数都小于 n)就是负 n 步。
+// 吃子后的局面查已经生成的小残局库。直到超过所有小残局库的杀棋步数后，一轮都没有变化为止
+bool generateTable(egtbTable* tb) {
+    int stm, i, nGenMoves, nLegal, pcCaptured, nValue, nDtm, nMaxSubDtm;
+    int mvs[MAX_GEN_MOVES];
+    uint32_t nIndex, nChild;
+    int64_t nChanged;
+    bool bWin, bLoss;
+    positionStruct posGen;
+
+    tb->lpValues = (unsigned char*)malloc((size_t)tb->nEntries * 2);
+    if (tb->lpValues == NULL) {
+        return false;
+    }
+    nMaxSubDtm = 0;
+    for (i = 0; i < Egtb.nTables; i++) {
+        nMaxSubDtm = Egtb.tables[i]->nMaxDtm > nMaxSubDtm ? Egtb.tables[i]->nMaxDtm : nMaxSubDtm;
+    }
+    tb->nMaxDtm = 0;
+
+    // 1. 不合法的局面：棋子重叠，或者不走棋的一方被将军
+    for (stm = 0; stm < 2; stm++) {
+        for (nIndex = 0; nIndex < tb->nEntries; nIndex++) {
+            nValue = EGTB_DRAW;
+            if (!indexPosition(tb, stm, nIndex, &posGen)) {
+                nValue = EGTB_INVALID;
+            }
+            else {
+                changeSide(&posGen);
+                nValue = checked(&posGen) ? EGTB_INVALID : EGTB_DRAW;
+                changeSide(&posGen);
+            }
+            if (nValue == EGTB_DRAW) {
+                // 没有合法的走法就输了(象棋中困毙也算输)
+                nLegal = 0;
+                nGenMoves = generateMoves(&posGen, mvs);
+                for (i = 0; i < nGenMoves && nLegal == 0; i++) {
+                    if (makeMove(&posGen, mvs[i], &pcCaptured)) {
+                        undoMakeMove(&posGen, mvs[i], pcCaptured);
+                        nLegal++;
+                    }
+                }
+                nValue = nLegal == 0 ? EGTB_LOSS : EGTB_DRAW;
+            }
+            tb->lpValues[(uint64_t)stm * tb->nEntries + nIndex] = (unsigned char)nValue;
+        }
+    }
+
+    // 2. 逐轮逆推
+    for (nDtm = 1; nDtm <= EGTB_MAX_DTM; nDtm++) {
+        nChanged = 0;
+        for (stm = 0; stm < 2; stm++) {
+            for (nIndex = 0; nIndex < tb->nEntries; nIndex++) {
+                if (tb->lpValues[(uint64_t)stm * tb->nEntries + nIndex] != EGTB_DRAW) {
+                    continue;
+                }
+                indexPosition(tb, stm, nIndex, &posGen);
+                bWin = false;
+                bLoss = true;
+                nGenMoves = generateMoves(&posGen, mvs);
+                for (i = 0; i < nGenMoves && !bWin; i++) {
+                    if (!makeMove(&posGen, mvs[i], &pcCaptured)) {
+                        continue;
+                    }
+                    // 对方的结果，这一轮新得到的结果(步数不小于 n)还不能用
+                    if (pcCaptured == 0) {
+                        positionIndex(tb, &posGen, false, &nChild);
+                        nValue = tb->lpValues[(uint64_t)(1 - stm) * tb->nEntries + nChild];
+                    }
+                    else if (!lookupValue(&posGen, &nValue)) {
+                        nValue = EGTB_DRAW;
+                    }
+                    undoMakeMove(&posGen, mvs[i], pcCaptured);
+                    if (nValue >= EGTB_LOSS && nValue != EGTB_INVALID && nValue - EGTB_LOSS < nDtm) {
+                        bWin = true;
+                    }
+                    else if (nValue == EGTB_DRAW || nValue >= EGTB_LOSS || nValue >= nDtm) {
+                        bLoss = false;
+                    }
+                }
+                if (bWin || bLoss) {
+                    tb->lpValues[(uint64_t)stm * tb->nEntries + nIndex] =
+                        (unsigned char)(bWin ? nDtm : EGTB_LOSS + nDtm);
+                    tb->nMaxDtm = nDtm;
+                    nChanged++;
+                }
+            }
+        }
+        if (nChanged == 0 && nDtm > nMaxSubDtm + 1) {
+            break;
+        }
+    }
+    return true;
+}
+
+// 生成一个子力组合的残局库，先递归生成吃子后会变成的组合
+bool makeTable(uint64_t nSig, const char* szDir) {
+    int side, pt;
+    uint64_t nSubSig;
+    egtbTable* tb;
+
+    if (!SIG_ATTACK(nSig) || findTable(nSig) != NULL) {
+        return true;
+    }
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+            if (SIG_COUNT(nSig, side, pt) != 0) {
+                nSubSig = nSig - ((uint64_t)1 << (18 * side + 3 * (pt - 1)));
+                if (!makeTable(SIG_CANONICAL(nSubSig) ? nSubSig : SIG_FLIP(nSubSig), szDir)) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (Egtb.nTables == EGTB_MAX_TABLES) {
+        return false;
+    }
+    tb = (egtbTable*)calloc(1, sizeof(egtbTable));
+    if (tb == NULL || !setupTable(tb, nSig) || !generateTable(tb) || !writeTable(tb, szDir)) {
+        if (tb != NULL) {
+            free(tb->lpValues);
+        }
+        free(tb);
+        return false;
+    }
+    addTable(tb);
+    return true;
+}
+
+bool egtbMake(const char* szMaterial, const char* szDir) {
+    uint64_t nSig;
+    int side, pt, n = 0;
+
+    if (!parseMaterial(szMaterial, &nSig)) {
+        printf("bad material %s\n", szMaterial);
+        return false;
+    }
+    for (side = 0; side < 2; side++) {
+        for (pt = PIECE_ADVISOR; pt <= PIECE_PAWN; pt++) {
+            n += SIG_COUNT(nSig, side, pt);
+        }
+    }
+    if (n > EGTB_MAX_PIECES) {
+        printf("too many pieces in %s\n", szMaterial);
+        return false;
+    }
+#ifdef _WIN32
+    _mkdir(szDir);
+#else
+    mkdir(szDir, 0755);
+#endif
+    // 目录中已有的残局库不再重新生成
+    egtbInit(szDir);
+    Egtb.nMadeEntries = Egtb.nMadeBytes = 0;
+    if (!makeTable(SIG_CANONICAL(nSig) ? nSig : SIG_FLIP(nSig), szDir)) {
+        return false;
+    }
+    // 压缩率是文件大小和每个局面一个字节的表的比
+    printf("total %lld positions, %lld bytes, ratio %.1f%%\n", (long long)Egtb.nMadeEntries,
+           (long long)Egtb.nMadeBytes, Egtb.nMadeEntries > 0 ? Egtb.nMadeBytes * 100.0 / Egtb.nMadeEntries : 0.0);
+    fflush(stdout);
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef LVENW_EGTB_H
+#define LVENW_EGTB_H
+
+// 残局库：对子力很少的组合用逆推的方法算出每个局面的胜、负、和以及到杀棋的步数，
+// 压缩后保存在磁盘上，搜索时通过内存映射查表。
+// 子力组合写成 "KRKAABB" 的形式，第一个 K 后面是一方的棋子，第二个 K 后面是另一方的棋子，
+// 字母与 FEN 相同。表里较强的一方总是红方，查黑方较强的局面时把棋盘旋转 180 度并交换双方。
+// 不考虑长将、长捉等规则；双方都没有车、马、炮、兵的组合当作和棋，不需要表
+
+#include "engine.h"
+
+#define EGTB_DIR            "egtb"          // 默认的残局库目录
+#define EGTB_MAX_PIECES     5               // 不算帅(将)，一个残局库最多的棋子数
+#define EGTB_MAX_TABLES     256             // 最多同时打开的残局库数
+
+// 打开目录中的所有残局库文件(*.egtb)，返回打开的个数，原来打开的残局库总是先关闭
+int egtbInit(const char* szDir);
+void egtbClose(void);
+
+// 查残局库，局面的子力组合有残局库时返回 true，*vl 是相对走子方的分值
+bool egtbProbe(positionStruct* pos, int* vl);
+
+// 生成 szMaterial 以及吃子后会变成的所有子力组合的残局库，写到 szDir 目录中
+bool egtbMake(const char* szMaterial, const char* szDir);
+
+#endif
@@ -0,0 +1,2191 @@
+#include <math.h>           // log、pow
+#include <chrono>           // steady_clock
+#include <thread>           // Lazy SMP 的辅助线程
+#include "engine.h"
+#include "egtb.h"
+#include "nnue.h"
+
+// 判断棋子是否在棋盘中的数组
+constexpr char inBoard[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// 判断棋子是否在九宫的数组
+constexpr char inFort[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// 判断步长是否符合特定走法的数组，1=帅(将)，2=仕(士)，3=相(象)
+constexpr char legalSpan[512] = {
+                       0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 3, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 2, 1, 2, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 2, 1, 2, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 3, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0
+};
+
+// 根据步长判断马是否蹩腿的数组
+constexpr char knightPin[512] = {
+                              0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,-16,  0,-16,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0, 16,  0, 16,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0
+};
+
+// 帅(将)的步长
+const char kingDelta[4] = { -16, -1, 1, 16 };
+
+// 仕(士)的步长
+const char advisorDelta[4] = { -17, -15, 15, 17 };
+
+// 马的步长，以帅(将)的步长 kingDelta 作为马腿
+const char knightDelta[4][2] = { 
+    {-33,-31},  // 向上走，马腿步长 -16
+    {-18, 14},  // 向左走，马腿步长 -1
+    {-14, 18},  // 向右走，马腿步长 1
+    { 31, 33}   // 向下走，马腿步长 1
+};
+
+// 马被将军的步长，以仕(士)的步长 advisorDelta 作为马腿
+const char knightCheckDelta[4][2] = { 
+    {-33, -18},  // 马在将的左上，马腿距离将的步长 -17
+    {-31, -14},  // 右上， 马腿步长 -15
+    { 14,  31},  // 左下
+    { 18,  33}  // 右下
+};
+
+// 棋盘初始设置 黑方 ID - 51 - 127, 红方 128 - 203
+const char boardStartup[256] = {
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0, 20, 19, 18, 17, 16, 17, 18, 19, 20,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0, 21,  0,  0,  0,  0,  0, 21,  0,  0,  0,  0,  0,
+  0,  0,  0, 22,  0, 22,  0, 22,  0, 22,  0, 22,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0, 14,  0, 14,  0, 14,  0, 14,  0, 14,  0,  0,  0,  0,
+  0,  0,  0,  0, 13,  0,  0,  0,  0,  0, 13,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0, 12, 11, 10,  9,  8,  9, 10, 11, 12,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+// 子力位置价值表
+constexpr int cucvlPiecePos[7][256] = {
+  { // 帅(将)
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  1,  1,  1,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  2,  2,  2,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0, 11, 15, 11,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 仕(士)
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0, 20,  0, 20,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0, 23,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0, 20,  0, 20,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 相(象)
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0, 20,  0,  0,  0, 20,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0, 18,  0,  0,  0, 23,  0,  0,  0, 18,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0, 20,  0,  0,  0, 20,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 马
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0, 90, 90, 90, 96, 90, 96, 90, 90, 90,  0,  0,  0,  0,
+    0,  0,  0, 90, 96,103, 97, 94, 97,103, 96, 90,  0,  0,  0,  0,
+    0,  0,  0, 92, 98, 99,103, 99,103, 99, 98, 92,  0,  0,  0,  0,
+    0,  0,  0, 93,108,100,107,100,107,100,108, 93,  0,  0,  0,  0,
+    0,  0,  0, 90,100, 99,103,104,103, 99,100, 90,  0,  0,  0,  0,
+    0,  0,  0, 90, 98,101,102,103,102,101, 98, 90,  0,  0,  0,  0,
+    0,  0,  0, 92, 94, 98, 95, 98, 95, 98, 94, 92,  0,  0,  0,  0,
+    0,  0,  0, 93, 92, 94, 95, 92, 95, 94, 92, 93,  0,  0,  0,  0,
+    0,  0,  0, 85, 90, 92, 93, 78, 93, 92, 90, 85,  0,  0,  0,  0,
+    0,  0,  0, 88, 85, 90, 88, 90, 88, 90, 85, 88,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 车
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,206,208,207,213,214,213,207,208,206,  0,  0,  0,  0,
+    0,  0,  0,206,212,209,216,233,216,209,212,206,  0,  0,  0,  0,
+    0,  0,  0,206,208,207,214,216,214,207,208,206,  0,  0,  0,  0,
+    0,  0,  0,206,213,213,216,216,216,213,213,206,  0,  0,  0,  0,
+    0,  0,  0,208,211,211,214,215,214,211,211,208,  0,  0,  0,  0,
+    0,  0,  0,208,212,212,214,215,214,212,212,208,  0,  0,  0,  0,
+    0,  0,  0,204,209,204,212,214,212,204,209,204,  0,  0,  0,  0,
+    0,  0,  0,198,208,204,212,212,212,204,208,198,  0,  0,  0,  0,
+    0,  0,  0,200,208,206,212,200,212,206,208,200,  0,  0,  0,  0,
+    0,  0,  0,194,206,204,212,200,212,204,206,194,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 炮
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,100,100, 96, 91, 90, 91, 96,100,100,  0,  0,  0,  0,
+    0,  0,  0, 98, 98, 96, 92, 89, 92, 96, 98, 98,  0,  0,  0,  0,
+    0,  0,  0, 97, 97, 96, 91, 92, 91, 96, 97, 97,  0,  0,  0,  0,
+    0,  0,  0, 96, 99, 99, 98,100, 98, 99, 99, 96,  0,  0,  0,  0,
+    0,  0,  0, 96, 96, 96, 96,100, 96, 96, 96, 96,  0,  0,  0,  0,
+    0,  0,  0, 95, 96, 99, 96,100, 96, 99, 96, 95,  0,  0,  0,  0,
+    0,  0,  0, 96, 96, 96, 96, 96, 96, 96, 96, 96,  0,  0,  0,  0,
+    0,  0,  0, 97, 96,100, 99,101, 99,100, 96, 97,  0,  0,  0,  0,
+    0,  0,  0, 96, 97, 98, 98, 98, 98, 98, 97, 96,  0,  0,  0,  0,
+    0,  0,  0, 96, 96, 97, 99, 99, 99, 97, 96, 96,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }, { // 兵(卒)
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  9,  9,  9, 11, 13, 11,  9,  9,  9,  0,  0,  0,  0,
+    0,  0,  0, 19, 24, 34, 42, 44, 42, 34, 24, 19,  0,  0,  0,  0,
+    0,  0,  0, 19, 24, 32, 37, 37, 37, 32, 24, 19,  0,  0,  0,  0,
+    0,  0,  0, 19, 23, 27, 29, 30, 29, 27, 23, 19,  0,  0,  0,  0,
+    0,  0,  0, 14, 18, 20, 27, 29, 27, 20, 18, 14,  0,  0,  0,  0,
+    0,  0,  0,  7,  0, 13,  0, 16,  0, 13,  0,  7,  0,  0,  0,  0,
+    0,  0,  0,  7,  0,  7,  0, 15,  0,  7,  0,  7,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+  }
+};
+
+zobristStruct Zobrist;  // Zobrist 键值表
+
+// 初始化 Zobrist 表，使用固定种子的 splitmix64，保证每次运行键值相同
+void initZobrist(void) {
+    uint64_t seed = 0X9E3779B97F4A7C15ULL;
+    uint64_t* keys = &Zobrist.player;
+    int i, n = 1 + 14 * 256;
+    for (i = 0; i < n; i++) {
+        uint64_t z = (seed += 0X9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0XBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0X94D049BB133111EBULL;
+        keys[i] = z ^ (z >> 31);
+    }
+}
+
+// 生成一种长度的线的走法表，在编译时求值
+template <int N>
+constexpr lineTable<N> makeLineTable(void) {
+    lineTable<N> t{};
+    int p = 0, o = 0, q = 0, d = 0;
+    for (p = 0; p < N; p++) {
+        for (o = 0; o < (1 << N); o++) {
+            lineMoves& lm = t.moves[p][o];
+            for (d = -1; d <= 1; d += 2) {
+                // 1. 空格
+                q = p + d;
+                while (q >= 0 && q < N && (o & (1 << q)) == 0) {
+                    lm.slide |= 1 << q;
+                    q += d;
+                }
+                if (q < 0 || q >= N) {
+                    continue;
+                }
+                // 2. 第一个棋子
+                lm.block |= 1 << q;
+                // 3. 隔一个棋子后的第一个棋子
+                q += d;
+                while (q >= 0 && q < N && (o & (1 << q)) == 0) {
+                    q += d;
+                }
+                if (q >= 0 && q < N) {
+                    lm.screen |= 1 << q;
+                }
+            }
+        }
+    }
+    return t;
+}
+
+// 车、炮的走法表，下标是所在的列(行)和整行(列)的占位
+constexpr lineTable<9> rankMoves = makeLineTable<9>();
+constexpr lineTable<10> fileMoves = makeLineTable<10>();
+
+#ifdef COMPACT_TABLES
+// 由上面的表生成紧凑的表，在编译时求值
+constexpr compactStruct makeCompact(void) {
+    compactStruct t{};
+    int i = 0, j = 0;
+    for (i = 0; i < 256; i++) {
+        t.squareFlags[i] = (unsigned char)((inBoard[i] != 0 ? SQUARE_BOARD : 0) | (inFort[i] != 0 ? SQUARE_FORT : 0));
+    }
+    for (i = 0; i < 512; i++) {
+        t.spans[i].span = legalSpan[i];
+        t.spans[i].pin = knightPin[i];
+    }
+    for (i = 0; i < 7; i++) {
+        for (j = 0; j < PIECE_POS_SIZE; j++) {
+            t.vlPiecePos[i][j] = (int16_t)cucvlPiecePos[i][PIECE_POS_BASE + j];
+        }
+    }
+    return t;
+}
+
+alignas(64) constexpr compactStruct Compact = makeCompact();
+#endif
+
+// 初始化引擎用到的各种表，程序启动时调用一次
+// 后期走法减少的深度，下标是剩余深度和走法序号，深度和序号越大减得越多
+unsigned char lmrTable[LIMIT_DEPTH][MAX_GEN_MOVES];
+
+void initLmr(void) {
+    int d, m;
+    for (d = 0; d < LIMIT_DEPTH; d++) {
+        for (m = 0; m < MAX_GEN_MOVES; m++) {
+            lmrTable[d][m] = d == 0 || m == 0 ? 0 : (unsigned char)(0.75 + log((double)d) * log((double)m) / 2.25);
+        }
+    }
+}
+
+void initEngine(void) {
+    initZobrist();
+#ifdef USE_BITBOARD
+    initBitboard();
+#endif
+    // 默认打开的搜索选项
+    Search.bPvs = true;
+    Search.bAspiration = true;
+    Search.bNullMove = true;
+    Search.bLmr = true;
+    Search.vlLazyMargin1 = LAZY_MARGIN_1;
+    Search.vlLazyMargin2 = LAZY_MARGIN_2;
+    initLmr();
+}
+
+positionStruct pos;  // 局面实例
+
+// 子力位置价值，nPiece 是去掉红黑标记的棋子，黑方的格子要先翻转
+inline int PIECE_POS_VALUE(int nPiece, int id) {
+#ifdef COMPACT_TABLES
+    return Compact.vlPiecePos[nPiece][id - PIECE_POS_BASE];
+#else
+    return cucvlPiecePos[nPiece][id];
+#endif
+}
+
+void clearBoard(positionStruct* pos) {  // 清空棋盘
+    pos->blackPlayer = false;
+    pos->vlRed = pos->vlBlack = 0;
+    pos->nDistance = 0;
+    pos->zobrist = 0;
+    memset(pos->curboard, 0, 256);
+    pos->nPieces[0] = pos->nPieces[1] = 0;
+    pos->kingSquare[0] = pos->kingSquare[1] = 0;
+    pos->nMoveNum = 1;
+    pos->moveStack[0].zobrist = 0;
+    pos->moveStack[0].mv = 0;
+    pos->moveStack[0].pcCaptured = 0;
+    pos->moveStack[0].bCheck = false;
+    memset(pos->rankOcc, 0, sizeof(pos->rankOcc));
+    memset(pos->fileOcc, 0, sizeof(pos->fileOcc));
+#ifdef USE_BITBOARD
+    pos->occSide[0] = pos->occSide[1] = BB_ZERO();
+#endif
+#ifdef USE_NNUE
+    pos->acc.bDirty[0] = pos->acc.bDirty[1] = true;
+#endif
+}
+void changeSide(positionStruct* pos) {  // 交换走子方
+    pos->blackPlayer ^= 1;
+    pos->zobrist ^= Zobrist.player;
+}
+void addPiece(positionStruct* pos, int id, int type) {  // 在棋盘上放一枚棋子
+    int side = SIDE_INDEX(type);
+    pos->curboard[id] = type;
+    pos->zobrist ^= Zobrist.table[ZOBRIST_INDEX(type)][id];
+    // 加到本方棋子列表的末尾
+    pos->pieceIndex[id] = (unsigned char)pos->nPieces[side];
+    pos->pieceList[side][pos->nPieces[side]++] = (unsigned char)id;
+    if (type - SIDE_TAG(side) == PIECE_KING)
+      pos->kingSquare[side] = id;
+    pos->rankOcc[Y(id)] ^= 1 << (X(id) - FILE_LEFT);
+    pos->fileOcc[X(id)] ^= 1 << (Y(id) - RANK_TOP);
+#ifdef USE_BITBOARD
+    pos->occSide[side] = BB_XOR(pos->occSide[side], squareBB[squareIndex[id]]);
+#endif
+    // 红方加分，黑方(注意"cucvlPiecePos"取值要颠倒)减分
+    if (type < 16)
+      pos->vlRed += PIECE_POS_VALUE(type - 8, id);
+    else
+      pos->vlBlack += PIECE_POS_VALUE(type - 16, SQUARE_FLIP(id));
+#ifdef USE_NNUE
+    nnueUpdate(pos, id, type, 1);
+#endif
+}
+void delPiece(positionStruct* pos, int id, int type) {  // 从棋盘上拿走一枚棋子
+    int side = SIDE_INDEX(type);
+    int idLast = pos->pieceList[side][--pos->nPieces[side]];
+    pos->curboard[id] = 0;
+    pos->zobrist ^= Zobrist.table[ZOBRIST_INDEX(type)][id];
+    // 用列表末尾的棋子填补空位
+    pos->pieceList[side][pos->pieceIndex[id]] = (unsigned char)idLast;
+    pos->pieceIndex[idLast] = pos->pieceIndex[id];
+    if (type - SIDE_TAG(side) == PIECE_KING)
+      pos->kingSquare[side] = 0;
+    pos->rankOcc[Y(id)] ^= 1 << (X(id) - FILE_LEFT);
+    pos->fileOcc[X(id)] ^= 1 << (Y(id) - RANK_TOP);
+#ifdef USE_BITBOARD
+    pos->occSide[side] = BB_XOR(pos->occSide[side], squareBB[squareIndex[id]]);
+#endif
+    if (type < 16)
+      pos->vlRed -= PIECE_POS_VALUE(type - 8, id);
+    else
+      pos->vlBlack -= PIECE_POS_VALUE(type - 16, SQUARE_FLIP(id));
+#ifdef USE_NNUE
+    nnueUpdate(pos, id, type, -1);
+#endif
+}
+
+// 帅(将)的安全：对方过河的进攻子力按缺少的仕(士)、相(象)扣分，再查空头炮
+int evalKingSafety(positionStruct* pos, int side) {
+    int i, id, type, idKing, nShield, nAttack, vl, pcOppSide;
+    unsigned bits;
+    const lineMoves* lm;
+
+    idKing = pos->kingSquare[side];
+    if (idKing == 0) {
+        return 0;
+    }
+    pcOppSide = OPP_SIDE_TAG(side);
+    nShield = 0;
+    for (i = 0; i < pos->nPieces[side]; i++) {
+        type = pos->curboard[pos->pieceList[side][i]] & 7;
+        if (type == PIECE_ADVISOR || type == PIECE_BISHOP) {
+            nShield++;
+        }
+    }
+    nAttack = 0;
+    for (i = 0; i < pos->nPieces[1 - side]; i++) {
+        id = pos->pieceList[1 - side][i];
+        type = pos->curboard[id] & 7;
+        if (type != PIECE_KING && type != PIECE_ADVISOR && type != PIECE_BISHOP && AWAY_HALF(id, 1 - side)) {
+            nAttack += type == PIECE_ROOK ? 2 : 1;
+        }
+    }
+    vl = -nAttack * (4 - nShield) * KING_SHIELD_VALUE;
+    lm = &fileMoves[Y(idKing) - RANK_TOP][pos->fileOcc[X(idKing)]];
+    for (bits = lm->block; bits != 0; bits &= bits - 1) {
+        if (pos->curboard[COORD_XY(X(idKing), RANK_TOP + LSB(bits))] == pcOppSide + PIECE_CANNON) {
+            vl -= HOLLOW_CANNON_VALUE;
+        }
+    }
+    return vl;
+}
+
+// 兵(卒)的连接：过河后左右相连的兵(卒)，每对只算一次
+int evalPawns(positionStruct* pos, int side) {
+    int i, id, pcPawn, vl;
+    pcPawn = SIDE_TAG(side) + PIECE_PAWN;
+    vl = 0;
+    for (i = 0; i < pos->nPieces[side]; i++) {
+        id = pos->pieceList[side][i];
+        if (pos->curboard[id] == pcPawn && AWAY_HALF(id, side) && pos->curboard[id + 1] == pcPawn) {
+            vl += PAWN_CHAIN_VALUE;
+        }
+    }
+    return vl;
+}
+
+// 车、马、炮的灵活性以及马炮配合，要查每个棋子能走的格子
+int evalMobility(positionStruct* pos, int side) {
+    int i, j, k, id, idDst, x, y, n, sideMask, vl;
+    bool bKnight, bCannon;
+    const lineMoves* lmRank;
+    const lineMoves* lmFile;
+
+    sideMask = SIDE_TAG(side);
+    vl = 0;
+    bKnight = bCannon = false;
+    for (i = 0; i < pos->nPieces[side]; i++) {
+        id = pos->pieceList[side][i];
+        switch (pos->curboard[id] - sideMask) {
+        case PIECE_KNIGHT:
+            // 1. 马腿没被挡住、终点没有本方棋子的格子，和 4 个比较
+            n = 0;
+            for (j = 0; j < 4; j++) {
+                if (pos->curboard[id + kingDelta[j]] != 0) {
+                    continue;
+                }
+                for (k = 0; k < 2; k++) {
+                    idDst = id + knightDelta[j][k];
+                    if (IN_BOARD(idDst) && (pos->curboard[idDst] & sideMask) == 0) {
+                        n++;
+                    }
+                }
+            }
+            vl += (n - 4) * KNIGHT_MOBILITY;
+            bKnight = bKnight || AWAY_HALF(id, side);
+            break;
+        case PIECE_ROOK:
+        case PIECE_CANNON:
+            // 2. 车、炮不吃子能走的空格，查行、列走法表
+            x = X(id);
+            y = Y(id);
+            lmRank = &rankMoves[x - FILE_LEFT][pos->rankOcc[y]];
+            lmFile = &fileMoves[y - RANK_TOP][pos->fileOcc[x]];
+            n = POPCOUNT(lmRank->slide) + POPCOUNT(lmFile->slide);
+            if (pos->curboard[id] - sideMask == PIECE_ROOK) {
+                vl += (n - 8) * ROOK_MOBILITY;
+            }
+            else {
+                vl += (n - 8) / 2 * CANNON_MOBILITY;
+                bCannon = bCannon || AWAY_HALF(id, side);
+            }
+            break;
+        }
+    }
+    // 3. 马炮配合
+    if (bKnight && bCannon) {
+        vl += KNIGHT_CANNON_VALUE;
+    }
+    return vl;
+}
+
+// 局面评价函数，按从便宜到昂贵分三层：
+// 1. 子力位置价值，走棋时增量更新；
+// 2. 帅(将)的安全和兵(卒)的连接；
+// 3. 车、马、炮的灵活性和马炮配合。
+// 前一层的分值离 (vlAlpha, vlBeta) 超过余量时，后面几层也拉不回窗口，直接返回加上余量后的边界。
+// 不给窗口时总是算完三层。余量取自 lpSearch，搜索时是搜索线程自己的 searchStruct。
+// 读入了神经网络的权重时改用网络评价，见 nnue.h
+int evaluate(positionStruct* pos, int vlAlpha, int vlBeta, const searchStruct* lpSearch) {
+    int vl, vlMargin;
+
+#ifdef USE_NNUE
+    // 读入了神经网络的权重就只用网络评价
+    if (Nnue.bLoaded) {
+        return nnueEvaluate(pos);
+    }
+#endif
+
+    // 1. 子力位置价值
+    vl = pos->vlBlack - pos->vlRed;
+    vl = (pos->blackPlayer ? vl : -vl) + ADVANCED_VALUE;
+    vlMargin = lpSearch->vlLazyMargin1;
+    if (vl + vlMargin <= vlAlpha) {
+        return vl + vlMargin;
+    }
+    if (vl - vlMargin >= vlBeta) {
+        return vl - vlMargin;
+    }
+
+    // 2. 帅(将)的安全和兵(卒)的连接
+    vl += (pos->blackPlayer ? -1 : 1) * (evalKingSafety(pos, 0) + evalPawns(pos, 0) -
+                                         evalKingSafety(pos, 1) - evalPawns(pos, 1));
+    vlMargin = lpSearch->vlLazyMargin2;
+    if (vl + vlMargin <= vlAlpha) {
+        return vl + vlMargin;
+    }
+    if (vl - vlMargin >= vlBeta) {
+        return vl - vlMargin;
+    }
+
+    // 3. 灵活性和马炮配合
+    vl += (pos->blackPlayer ? -1 : 1) * (evalMobility(pos, 0) - evalMobility(pos, 1));
+    return vl;
+}
+
+// 搬一步棋的棋子
+int movePiece(positionStruct* pos, int mv) {
+    int idSrc, idDst, type, pcCaptured;
+    idSrc = SRC(mv);
+    idDst = DST(mv);
+    pcCaptured = pos->curboard[idDst];
+    if (pcCaptured)
+        delPiece(pos, idDst, pcCaptured);
+    type = pos->curboard[idSrc];
+    delPiece(pos, idSrc, type);
+    addPiece(pos, idDst, type);
+    return pcCaptured;
+}
+
+// 撤消搬一步棋的棋子
+void undoMovePiece(positionStruct* pos, int mv, int typeDst) {
+    int idSrc, idDst, typeSrc;
+    idSrc = SRC(mv);
+    idDst = DST(mv);
+    typeSrc = pos->curboard[idDst];
+    delPiece(pos, idDst, typeSrc);
+    addPiece(pos, idSrc, typeSrc);
+    if (typeDst)
+        addPiece(pos, idDst, typeDst);
+}
+
+// 压入一项历史走法
+inline void pushMove(positionStruct* pos, uint64_t zobrist, int mv, int pcCaptured, bool bCheck) {
+    moveStackItem* lpItem = &pos->moveStack[pos->nMoveNum++];
+    assert(pos->nMoveNum <= MAX_MOVE_NUM);
+    lpItem->zobrist = zobrist;
+    lpItem->mv = mv;
+    lpItem->pcCaptured = (char)pcCaptured;
+    lpItem->bCheck = bCheck;
+}
+
+  // 撤消走一步棋
+void undoMakeMove(positionStruct* pos, int mv, int pcCaptured) {
+    pos->nMoveNum--;
+    pos->nDistance--;
+    changeSide(pos);
+    undoMovePiece(pos, mv, pcCaptured);
+}
+
+// 走一步空着，只交换走子方
+void makeNullMove(positionStruct* pos) {
+    pushMove(pos, pos->zobrist, 0, 0, false);
+    changeSide(pos);
+    pos->nDistance++;
+}
+
+// 撤消一步空着
+void undoMakeNullMove(positionStruct* pos) {
+    pos->nMoveNum--;
+    pos->nDistance--;
+    changeSide(pos);
+}
+
+// 空着裁剪用的进攻子力：车 6，马、炮 3，兵 1，帅(将)、仕(士)、相(象)不算
+const int nullMaterial[7] = { 0, 0, 0, 3, 6, 3, 1 };
+
+// 走子方的进攻子力是否足够做空着裁剪，子力少时容易出现"等着"(不走棋反而更好)的局面
+bool nullOkay(positionStruct* pos) {
+    int k, nMaterial = 0, side = pos->blackPlayer;
+    for (k = 0; k < pos->nPieces[side]; k++) {
+        nMaterial += nullMaterial[pos->curboard[pos->pieceList[side][k]] & 7];
+    }
+    return nMaterial >= NULL_MATERIAL;
+}
+
+// 从当前局面开始重新记录历史走法，对局中吃子以后，以前的局面不会再出现
+void setIrreversible(positionStruct* pos) {
+    pos->nMoveNum = 0;
+    pushMove(pos, pos->zobrist, 0, 0, checked(pos));
+}
+
+// 走子方 id 格上的棋子能合法吃到的对方棋子，格子存到 lpTargets，返回个数
+int pieceTargets(positionStruct* pos, int id, int* lpTargets) {
+    int i, n = 0, nGenMoves, pcCaptured;
+    int mvs[MAX_GEN_MOVES];
+    nGenMoves = generateMoves(pos, mvs, GEN_CAPTURE);
+    for (i = 0; i < nGenMoves; i++) {
+        if (SRC(mvs[i]) == id && makeMove(pos, mvs[i], &pcCaptured)) {
+            undoMakeMove(pos, mvs[i], pcCaptured);
+            lpTargets[n++] = DST(mvs[i]);
+        }
+    }
+    return n;
+}
+
+// 走子方能否合法地吃掉 id 格上的棋子
+bool canCapture(positionStruct* pos, int id) {
+    int i, nGenMoves, pcCaptured;
+    int mvs[MAX_GEN_MOVES];
+    nGenMoves = generateMoves(pos, mvs, GEN_CAPTURE);
+    for (i = 0; i < nGenMoves; i++) {
+        if (DST(mvs[i]) == id && makeMove(pos, mvs[i], &pcCaptured)) {
+            undoMakeMove(pos, mvs[i], pcCaptured);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 判断走法是否捉子：走完以后，走的棋子新攻击到对方的一个棋子，吃掉以后对方吃不回来，或者用马、炮攻击车。
+// 帅(将)、兵(卒)可以随便捉；攻击帅(将)、没过河的兵(卒)不算
+bool chaseMove(positionStruct* pos, int mv) {
+    int i, j, n, nOld, pc, pcTarget, pcCaptured, pcRecapture, idTarget, side;
+    int targetsOld[MAX_GEN_MOVES], targets[MAX_GEN_MOVES];
+    bool bChase = false;
+
+    side = pos->blackPlayer;
+    pc = pos->curboard[SRC(mv)] & 7;
+    if (pc == PIECE_KING || pc == PIECE_PAWN) {
+        return false;
+    }
+    nOld = pieceTargets(pos, SRC(mv), targetsOld);
+    if (!makeMove(pos, mv, &pcCaptured)) {
+        return false;
+    }
+    // 走完以后轮到对方，要交换走子方才能看走的棋子攻击到哪些棋子
+    changeSide(pos);
+    n = pieceTargets(pos, DST(mv), targets);
+    for (i = 0; i < n && !bChase; i++) {
+        idTarget = targets[i];
+        pcTarget = pos->curboard[idTarget] & 7;
+        for (j = 0; j < nOld && targetsOld[j] != idTarget; j++) {
+        }
+        if (j < nOld || pcTarget == PIECE_KING || (pcTarget == PIECE_PAWN && HOME_HALF(idTarget, 1 - side))) {
+            continue;
+        }
+        if (pcTarget == PIECE_ROOK && (pc == PIECE_KNIGHT || pc == PIECE_CANNON)) {
+            bChase = true;
+        }
+        else {
+            makeMove(pos, MOVE(DST(mv), idTarget), &pcRecapture);
+            bChase = !canCapture(pos, idTarget);
+            undoMakeMove(pos, MOVE(DST(mv), idTarget), pcRecapture);
+        }
+    }
+    changeSide(pos);
+    undoMakeMove(pos, mv, pcCaptured);
+    return bChase;
+}
+
+// 检查重复局面：从最后一步往前查，遇到吃子或空着就停止，之前的局面不可能重复。
+// 找到和当前局面相同的局面时，看这一段中双方是否每步都将军(长将)或每步都捉子(长捉)，
+// 长将比长捉重，较重的一方判负，双方一样算和棋
+int repStatus(positionStruct* pos) {
+    int i, k, nEnd, nOwn, nOpp, pcCaptured;
+    int mvs[MAX_MOVE_NUM];
+    bool bSelf = false, bChase, bOwnCheck = true, bOppCheck = true, bOwnChase = false, bOppChase = false;
+    moveStackItem* lpItem;
+
+    // 1. 往前找相同的局面，最后一步是对方走的
+    for (i = pos->nMoveNum - 1; ; i--) {
+        lpItem = &pos->moveStack[i];
+        if (lpItem->mv == 0 || lpItem->pcCaptured != 0) {
+            return REP_NONE;
+        }
+        if (bSelf) {
+            bOwnCheck = bOwnCheck && lpItem->bCheck;
+            if (lpItem->zobrist == pos->zobrist) {
+                break;
+            }
+        }
+        else {
+            bOppCheck = bOppCheck && lpItem->bCheck;
+        }
+        bSelf = !bSelf;
+    }
+
+    // 2. 都没有长将时再看长捉：退回到重复的局面，再逐步走回来，判断每步是否捉子
+    if (!bOwnCheck && !bOppCheck) {
+        bOwnChase = bOppChase = true;
+        nEnd = pos->nMoveNum;
+        for (k = nEnd - 1; k >= i; k--) {
+            mvs[k] = pos->moveStack[k].mv;
+            undoMakeMove(pos, mvs[k], 0);
+        }
+        bSelf = true;
+        for (k = i; k < nEnd; k++) {
+            if (bSelf ? bOwnChase : bOppChase) {
+                bChase = chaseMove(pos, mvs[k]);
+                bOwnChase = bOwnChase && (!bSelf || bChase);
+                bOppChase = bOppChase && (bSelf || bChase);
+            }
+            makeMove(pos, mvs[k], &pcCaptured);
+            bSelf = !bSelf;
+        }
+    }
+
+    nOwn = bOwnCheck ? 2 : bOwnChase ? 1 : 0;
+    nOpp = bOppCheck ? 2 : bOppChase ? 1 : 0;
+    return nOwn == nOpp ? REP_DRAW : nOwn > nOpp ? REP_LOSS : REP_WIN;
+}
+
+// 重复局面的分值，长将、长捉判负的分值按距离根节点的步数调整
+int repValue(positionStruct* pos, int nStatus) {
+    return nStatus == REP_LOSS ? pos->nDistance - BAN_VALUE :
+           nStatus == REP_WIN ? BAN_VALUE - pos->nDistance : 0;
+}
+
+// 判断是否被将军
+bool checked(positionStruct* pos) {
+    int i, j, idSrc, x, y, typeDst, nDelta, pcOppSide;
+    unsigned bits;
+    const lineMoves* lmRank;
+    const lineMoves* lmFile;
+    pcOppSide = OPP_SIDE_TAG(pos->blackPlayer);
+
+    // 直接从帅(将)所在的格子开始判断：
+    idSrc = pos->kingSquare[pos->blackPlayer];
+    if (idSrc == 0) {
+        return false;
+    }
+
+    // 1. 判断是否被对方的兵(卒)将军，按兵的走法走一步看是否会碰上对方的兵
+    if (pos->curboard[SQUARE_FORWARD(idSrc, pos->blackPlayer)] ==
+        pcOppSide + PIECE_PAWN) {
+        return true;
+    }
+    for (nDelta = -1; nDelta <= 1; nDelta += 2) {
+        if (pos->curboard[idSrc + nDelta] == pcOppSide + PIECE_PAWN) {
+            return true;
+        }
+    }
+
+    // 2. 判断是否被对方的马将军(以仕(士)的步长当作马腿)
+    for (i = 0; i < 4; i++) {
+        // 从将的角度计算马腿
+        if (pos->curboard[idSrc + advisorDelta[i]] != 0) {
+            continue;
+        }
+        for (j = 0; j < 2; j++) {
+            typeDst = pos->curboard[idSrc + knightCheckDelta[i][j]];
+            if (typeDst == pcOppSide + PIECE_KNIGHT) {
+                return true;
+            }
+        }
+    }
+
+    // 3. 判断是否被对方的车或炮将军(包括将帅对脸)，查行、列走法表得到最多 8 个需要检查的格子
+    x = X(idSrc);
+    y = Y(idSrc);
+    lmRank = &rankMoves[x - FILE_LEFT][pos->rankOcc[y]];
+    lmFile = &fileMoves[y - RANK_TOP][pos->fileOcc[x]];
+    for (bits = lmRank->block; bits != 0; bits &= bits - 1) {
+        if (pos->curboard[COORD_XY(FILE_LEFT + LSB(bits), y)] == pcOppSide + PIECE_ROOK) {
+            return true;
+        }
+    }
+    for (bits = lmFile->block; bits != 0; bits &= bits - 1) {
+        typeDst = pos->curboard[COORD_XY(x, RANK_TOP + LSB(bits))];
+        if (typeDst == pcOppSide + PIECE_ROOK || typeDst == pcOppSide + PIECE_KING) {
+            return true;
+        }
+    }
+    for (bits = lmRank->screen; bits != 0; bits &= bits - 1) {
+        if (pos->curboard[COORD_XY(FILE_LEFT + LSB(bits), y)] == pcOppSide + PIECE_CANNON) {
+            return true;
+        }
+    }
+    for (bits = lmFile->screen; bits != 0; bits &= bits - 1) {
+        if (pos->curboard[COORD_XY(x, RANK_TOP + LSB(bits))] == pcOppSide + PIECE_CANNON) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 走一步棋
+bool makeMove(positionStruct* pos, int mv, int *typeDst) {
+    uint64_t zobrist = pos->zobrist;
+    *typeDst = movePiece(pos, mv);
+    if (checked(pos)) {
+        undoMovePiece(pos, mv, *typeDst);
+        return false;
+    }
+    changeSide(pos);
+    pushMove(pos, zobrist, mv, *typeDst, checked(pos));
+    pos->nDistance++;
+    return true;
+}
+
+// 走一步已知不送将的棋，不用再判断是否被将军
+void makeLegalMove(positionStruct* pos, int mv, int* typeDst) {
+    uint64_t zobrist = pos->zobrist;
+    *typeDst = movePiece(pos, mv);
+    changeSide(pos);
+    pushMove(pos, zobrist, mv, *typeDst, checked(pos));
+    pos->nDistance++;
+}
+
+#ifndef USE_BITBOARD
+// 生成所有走法
+int generateMoves(positionStruct* pos, int* mvs, int nMode) {
+    int i, j, k, nGenMoves, nDelta, idSrc, idDst, x, y;
+    int sideMask, pcOppSide, typeSrc, typeDst;
+    // 生成所有走法，需要经过以下几个步骤：
+
+    nGenMoves = 0;
+    sideMask = SIDE_TAG(pos->blackPlayer);
+    pcOppSide = OPP_SIDE_TAG(pos->blackPlayer);
+    for (k = 0; k < pos->nPieces[pos->blackPlayer]; k++) {
+        // 1. 从本方棋子列表中取出一个棋子，再做以下判断：
+        idSrc = pos->pieceList[pos->blackPlayer][k];
+        typeSrc = pos->curboard[idSrc];
+
+        // 2. 根据棋子确定走法
+        switch (typeSrc - sideMask) {
+        case PIECE_KING:
+            for (i = 0; i < 4; i++) {
+                idDst = idSrc + kingDelta[i];
+                if (!IN_FORT(idDst)) {
+                    continue;
+                }
+                typeDst = pos->curboard[idDst];
+                // des 位置无子或者没有自己的棋子
+                if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                    mvs[nGenMoves] = MOVE(idSrc, idDst);
+                    nGenMoves++;
+                }
+            }
+            break;
+        case PIECE_ADVISOR:
+            for (i = 0; i < 4; i++) {
+                idDst = idSrc + advisorDelta[i];
+                if (!IN_FORT(idDst)) {
+                    continue;
+                }
+                typeDst = pos->curboard[idDst];
+                // des 位置无子或者没有自己的棋子
+                if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                    mvs[nGenMoves] = MOVE(idSrc, idDst);
+                    nGenMoves++;
+                }
+            }
+            break;
+        case PIECE_BISHOP:
+            for (i = 0; i < 4; i++) {
+                idDst = idSrc + advisorDelta[i];
+                // 1. 先验证象眼
+                if (!(IN_BOARD(idDst) && HOME_HALF(idDst, pos->blackPlayer) &&
+                    pos->curboard[idDst] == 0)) {
+                    continue;
+                }
+                // 2. 继续走一步，无需验证 IN_BOARD
+                idDst += advisorDelta[i];
+                typeDst = pos->curboard[idDst];
+                if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                    mvs[nGenMoves] = MOVE(idSrc, idDst);
+                    nGenMoves++;
+                }
+            }
+            break;
+        case PIECE_KNIGHT:
+            for (i = 0; i < 4; i++) {
+                // 1. 看看马腿有没有棋子
+                idDst = idSrc + kingDelta[i];
+                if (pos->curboard[idDst] != 0) {
+                    continue;
+                }
+                // 2. 每个马腿有两个方向
+                for (j = 0; j < 2; j++) {
+                    idDst = idSrc + knightDelta[i][j];
+                    if (!IN_BOARD(idDst)) {
+                        continue;
+                    }
+                    // 3. des 位置无子或者没有自己的棋子
+                    typeDst = pos->curboard[idDst];
+                    if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                        mvs[nGenMoves] = MOVE(idSrc, idDst);
+                        nGenMoves++;
+                    }
+                }
+            }
+            break;
+        case PIECE_ROOK:
+        case PIECE_CANNON:
+            // 查行、列走法表，下标是棋子在线上的位置和整条线的占位
+            x = X(idSrc);
+            y = Y(idSrc);
+            nGenMoves += lineMovesGen(pos, &rankMoves[x - FILE_LEFT][pos->rankOcc[y]],
+                                      typeSrc - sideMask == PIECE_CANNON, idSrc,
+                                      COORD_XY(FILE_LEFT, y), 1, pcOppSide, nMode, mvs + nGenMoves);
+            nGenMoves += lineMovesGen(pos, &fileMoves[y - RANK_TOP][pos->fileOcc[x]],
+                                      typeSrc - sideMask == PIECE_CANNON, idSrc,
+                                      COORD_XY(x, RANK_TOP), 16, pcOppSide, nMode, mvs + nGenMoves);
+            break;
+        case PIECE_PAWN:
+            // 1. 前进一步是否合法
+            idDst = SQUARE_FORWARD(idSrc, pos->blackPlayer);
+            if (IN_BOARD(idDst)) {
+                typeDst = pos->curboard[idDst];
+                if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                    mvs[nGenMoves] = MOVE(idSrc, idDst);
+                    nGenMoves++;
+                }
+            }
+            // 2. 左右是否能走
+            if (AWAY_HALF(idSrc, pos->blackPlayer)) {
+                for (nDelta = -1; nDelta <= 1; nDelta += 2) {
+                    idDst = idSrc + nDelta;
+                    if (IN_BOARD(idDst)) {
+                        typeDst = pos->curboard[idDst];
+                        if (GEN_WANTED(typeDst, sideMask, nMode)) {
+                            mvs[nGenMoves] = MOVE(idSrc, idDst);
+                            nGenMoves++;
+                        }
+                    }
+                }
+            }
+            break;
+        }
+    }
+    return nGenMoves;
+}
+#endif
+
+// 判断走法是否合理
+bool legalMove(positionStruct* pos, int mv) {
+    int idSrc, idDst, sqPin, bit;
+    int sideMask, typeSrc, typeDst;
+    const lineMoves* lm;
+    // 判断走法是否合法，需要经过以下的判断过程：
+
+    // 1. 判断起始格是否有自己的棋子
+    idSrc = SRC(mv);
+    typeSrc = pos->curboard[idSrc];
+    sideMask = SIDE_TAG(pos->blackPlayer);
+    if ((typeSrc & sideMask) == 0) {
+        return false;
+    }
+
+    // 2. 判断目标格是否有自己的棋子
+    idDst = DST(mv);
+    typeDst = pos->curboard[idDst];
+    if ((typeDst & sideMask) != 0) {
+        return false;
+    }
+
+    // 3. 根据棋子的类型检查走法是否合理
+    switch (typeSrc - sideMask) {
+    case PIECE_KING:
+        return IN_FORT(idDst) && KING_SPAN(idSrc, idDst);
+    case PIECE_ADVISOR:
+        return IN_FORT(idDst) && ADVISOR_SPAN(idSrc, idDst);
+    case PIECE_BISHOP:
+        return SAME_HALF(idSrc, idDst) && BISHOP_SPAN(idSrc, idDst) &&
+            pos->curboard[BISHOP_PIN(idSrc, idDst)] == 0;
+    case PIECE_KNIGHT:
+        sqPin = KNIGHT_PIN(idSrc, idDst);
+        return sqPin != idSrc && pos->curboard[sqPin] == 0;
+    case PIECE_ROOK:
+    case PIECE_CANNON:
+        // 查行、列走法表，终点对应的位在不吃子、车吃子或炮吃子的目标中
+        if (SAME_RANK(idSrc, idDst)) {
+            lm = &rankMoves[X(idSrc) - FILE_LEFT][pos->rankOcc[Y(idSrc)]];
+            bit = 1 << (X(idDst) - FILE_LEFT);
+        }
+        else if (SAME_FILE(idSrc, idDst)) {
+            lm = &fileMoves[Y(idSrc) - RANK_TOP][pos->fileOcc[X(idSrc)]];
+            bit = 1 << (Y(idDst) - RANK_TOP);
+        }
+        else {
+            return false;
+        }
+        if (typeDst == 0) {
+            return (lm->slide & bit) != 0;
+        }
+        return ((typeSrc - sideMask == PIECE_ROOK ? lm->block : lm->screen) & bit) != 0;
+    case PIECE_PAWN:
+        if (AWAY_HALF(idDst, pos->blackPlayer) &&
+            (idDst == idSrc - 1 || idDst == idSrc + 1)) {
+            return true;
+        }
+        return idDst == SQUARE_FORWARD(idSrc, pos->blackPlayer);
+    default:
+        return false;
+    }
+}
+
+// id 在帅(将)的哪个方向上，返回 pinStruct::nRayMask 中对应的位，不在同一行、列返回 0
+inline int RAY_MASK(int idKing, int id) {
+    return SAME_FILE(id, idKing) ? (id < idKing ? 1 : 8) : SAME_RANK(id, idKing) ? (id < idKing ? 2 : 4) : 0;
+}
+
+// 计算走子方帅(将)受到的牵制
+void initPins(positionStruct* pos, pinStruct* pins) {
+    int i, j, n, id, idKing, idKnight, nKnights, pcOppSide, sideMask, type;
+
+    sideMask = SIDE_TAG(pos->blackPlayer);
+    pcOppSide = OPP_SIDE_TAG(pos->blackPlayer);
+    idKing = pos->kingSquare[pos->blackPlayer];
+    pins->bInCheck = pos->moveStack[pos->nMoveNum - 1].bCheck;
+    pins->idKing = idKing;
+    pins->nRayMask = 0;
+    pins->nPins = 0;
+    if (idKing == 0 || pins->bInCheck) {
+        return;
+    }
+
+    // 1. 四个方向上最近的三个棋子中有对方的车、炮、帅(将)，走开一个棋子、多一个棋子或者吃子后换成本方的棋子，
+    //    都可能让它将军；更远的车被三个棋子挡住，炮至少还有两个炮架，不会将军
+    for (i = 0; i < 4; i++) {
+        n = 0;
+        for (id = idKing + kingDelta[i]; IN_BOARD(id) && n < 3; id += kingDelta[i]) {
+            type = pos->curboard[id];
+            if (type == 0) {
+                continue;
+            }
+            n++;
+            if (type == pcOppSide + PIECE_ROOK || type == pcOppSide + PIECE_CANNON ||
+                type == pcOppSide + PIECE_KING) {
+                pins->nRayMask |= 1 << i;
+                break;
+            }
+        }
+    }
+
+    // 2. 本方棋子做马腿，挡住了对方的马，只能吃掉这个马，挡住两个马就不能走
+    for (i = 0; i < 4; i++) {
+        id = idKing + advisorDelta[i];
+        if ((pos->curboard[id] & sideMask) == 0) {
+            continue;
+        }
+        nKnights = 0;
+        idKnight = 0;
+        for (j = 0; j < 2; j++) {
+            if (pos->curboard[idKing + knightCheckDelta[i][j]] == pcOppSide + PIECE_KNIGHT) {
+                nKnights++;
+                idKnight = idKing + knightCheckDelta[i][j];
+            }
+        }
+        if (nKnights > 0) {
+            pins->idPinned[pins->nPins] = id;
+            pins->idLimit[pins->nPins++] = nKnights == 1 ? idKnight : 0;
+        }
+    }
+}
+
+// 判断伪合法的走法是否送将，只有被将军、走帅(将)或者走到有对方车、炮、帅(将)的方向上时才试走
+bool safeMove(positionStruct* pos, const pinStruct* pins, int mv) {
+    int i, pcCaptured, idSrc, idDst, idKing;
+    bool bSafe;
+
+    idSrc = SRC(mv);
+    idDst = DST(mv);
+    idKing = pins->idKing;
+    // 1. 被将军时，帅(将)以外的棋子只有吃掉将军的棋子、挡住将军或者拿走炮架才能应将，
+    //    起点、终点都不在帅(将)所在的行、列，终点不是马腿，也不吃马的走法不用试
+    if (pins->bInCheck && idSrc != idKing && RAY_MASK(idKing, idSrc) == 0 &&
+        RAY_MASK(idKing, idDst) == 0 && (pos->curboard[idDst] & 7) != PIECE_KNIGHT) {
+        for (i = 0; i < 4 && idDst != idKing + advisorDelta[i]; i++) {
+        }
+        if (i == 4) {
+            return false;
+        }
+    }
+    if (pins->bInCheck || idSrc == idKing ||
+        (pins->nRayMask & (RAY_MASK(idKing, idSrc) | RAY_MASK(idKing, idDst))) != 0) {
+        pcCaptured = movePiece(pos, mv);
+        bSafe = !checked(pos);
+        undoMovePiece(pos, mv, pcCaptured);
+        return bSafe;
+    }
+
+    // 2. 做马腿的棋子
+    for (i = 0; i < pins->nPins; i++) {
+        if (pins->idPinned[i] == idSrc) {
+            return idDst == pins->idLimit[i];
+        }
+    }
+    return true;
+}
+
+// 生成不送将的走法
+int generateLegalMoves(positionStruct* pos, const pinStruct* pins, int* mvs, int nMode) {
+    int i, n = 0, nGenMoves;
+    nGenMoves = generateMoves(pos, mvs, nMode);
+    for (i = 0; i < nGenMoves; i++) {
+        if (safeMove(pos, pins, mvs[i])) {
+            mvs[n++] = mvs[i];
+        }
+    }
+    return n;
+}
+
+// 是否有不送将的走法，没有就是被杀(或者困毙)
+bool hasLegalMove(positionStruct* pos) {
+    int i, nGenMoves;
+    int mvs[MAX_GEN_MOVES];
+    pinStruct pins;
+
+    initPins(pos, &pins);
+    nGenMoves = generateMoves(pos, mvs);
+    for (i = 0; i < nGenMoves; i++) {
+        if (safeMove(pos, &pins, mvs[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+searchStruct Search;  // 与搜索有关的全局变量
+
+// 墙上时间(毫秒)，多线程搜索时 clock() 统计的是所有线程的 CPU 时间，不能用来计时
+int64_t searchClock(void) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 分配搜索线程的数据并清零，nThreads 包括主线程，失败返回 false
+bool threadsInit(int nThreads, searchStruct* lpSearch) {
+    int i;
+    threadStruct* threads;
+    nThreads = nThreads < 1 ? 1 : nThreads > MAX_THREADS ? MAX_THREADS : nThreads;
+    threads = (threadStruct*)calloc(nThreads, sizeof(threadStruct));
+    if (threads == NULL) {
+        return false;
+    }
+    for (i = 0; i < nThreads; i++) {
+        threads[i].nThread = i;
+        threads[i].lpSearch = lpSearch;
+    }
+    free(lpSearch->threads);
+    lpSearch->threads = threads;
+    lpSearch->nThreads = nThreads;
+    lpSearch->bWarmHistory = false;  // 新分配的线程没有历史表可以保留
+    return true;
+}
+
+// 是否要停止搜索：外部要求停止，超时，主线程已经结束(只对辅助线程)，或者主线程超出了节点数，
+// 辅助线程不单独限制节点数，主线程停止后由 bHelperStop 停止
+bool searchStopped(threadStruct* thd) {
+    searchStruct* lpSearch = thd->lpSearch;
+    return lpSearch->bStop.load(std::memory_order_relaxed) ||
+           lpSearch->bTimeout.load(std::memory_order_relaxed) ||
+           (thd->nThread != 0 && lpSearch->bHelperStop.load(std::memory_order_relaxed)) ||
+           (thd->nThread == 0 && lpSearch->nMaxNodes != 0 && thd->nNodes >= lpSearch->nMaxNodes);
+}
+
+// 分配这一步的时间：固定每步时间时，不开始新迭代和中止搜索的时间相同；用棋钟时平均分配剩余时间，
+// 再加上大部分加秒，迭代中途可以延长到 4 倍，但都不超过留出余量后剩余时间的一半
+void allocateTime(searchStruct* lpSearch) {
+    int nMovesToGo, nAlloc, nLimit;
+    lpSearch->nSoftTime = lpSearch->nHardTime = 0;
+    if (lpSearch->nMaxTime != 0) {
+        lpSearch->nSoftTime = lpSearch->nHardTime = lpSearch->nMaxTime;
+    }
+    else if (lpSearch->nClockTime != 0) {
+        nMovesToGo = lpSearch->nMovesToGo > 0 ? lpSearch->nMovesToGo : MOVES_TO_GO;
+        nLimit = (lpSearch->nClockTime - TIME_MARGIN) / 2;
+        nLimit = nLimit > 1 ? nLimit : 1;
+        nAlloc = lpSearch->nClockTime / nMovesToGo + lpSearch->nIncrement * 3 / 4;
+        lpSearch->nSoftTime = nAlloc < nLimit ? nAlloc : nLimit;
+        lpSearch->nHardTime = nAlloc * 4 < nLimit ? nAlloc * 4 : nLimit;
+    }
+}
+
+// 统计节点数，主线程每 POLL_NODES 个节点检查一次时间，超时就让所有线程停下来
+inline void countNode(threadStruct* thd) {
+    thd->nNodes++;
+    if ((thd->nNodes & (POLL_NODES - 1)) == 0 && thd->nThread == 0 && thd->lpSearch->nHardTime != 0 &&
+        !thd->lpSearch->bPonder && searchClock() - thd->lpSearch->tStart >= thd->lpSearch->nHardTime) {
+        thd->lpSearch->bTimeout = true;
+    }
+}
+
+// 置换表项，16 字节，一个桶放 HASH_BUCKET 项，正好一条 64 字节缓存行。
+// 多个线程同时读写而不加锁："key" 保存键值和 "data" 的异或，读到另一个线程写了一半的项时
+// 两个字对不上，校验不通过，就当作没有命中
+typedef struct hashItem {
+    std::atomic<uint64_t> key;  // 局面的 Zobrist 键值异或 data
+    std::atomic<uint64_t> data; // 走法、分值、深度、类型和代数，见 HASH_DATA
+} hashItem;
+
+typedef struct hashBucket {
+    alignas(64) hashItem items[HASH_BUCKET];
+} hashBucket;
+
+// 置换表
+struct {
+    hashBucket* buckets;        // 按缓存行对齐的桶
+    void* raw;                  // malloc 得到的原始指针，释放时使用
+    uint64_t mask;              // 桶数减一，桶数是 2 的幂
+    std::atomic<uint8_t> generation;  // 当前搜索代数，每次 searchMain 加一，可能有几个搜索同时进行
+} Hash;
+
+// 打包置换表项的内容：走法 16 位，分值 16 位(杀棋分值按距离根节点的步数做过调整)，
+// 深度 8 位，类型 8 位(HASH_ALPHA/HASH_BETA/HASH_PV/HASH_MOVE，0 表示空项)，代数 8 位
+inline uint64_t HASH_DATA(int mv, int vl, int nDepth, int nFlag, int nGeneration) {
+    return (uint64_t)(uint16_t)mv | ((uint64_t)(uint16_t)vl << 16) | ((uint64_t)(uint8_t)nDepth << 32) |
+           ((uint64_t)(uint8_t)nFlag << 40) | ((uint64_t)(uint8_t)nGeneration << 48);
+}
+
+inline int HASH_MV(uint64_t data) {
+    return (int)(data & 0XFFFF);
+}
+
+inline int HASH_VL(uint64_t data) {
+    return (int16_t)(data >> 16);
+}
+
+inline int HASH_DEPTH(uint64_t data) {
+    return (int)((data >> 32) & 0XFF);
+}
+
+inline int HASH_FLAG(uint64_t data) {
+    return (int)((data >> 40) & 0XFF);
+}
+
+inline int HASH_GENERATION(uint64_t data) {
+    return (int)((data >> 48) & 0XFF);
+}
+
+// 分配置换表，大小取不超过 nMB 的 2 的幂，失败返回 false
+bool hashInit(int nMB) {
+    uint64_t nBuckets = 1;
+    uint64_t nBytes = (uint64_t)(nMB > 0 ? nMB : 1) << 20;
+    while (nBuckets * 2 * sizeof(hashBucket) <= nBytes) {
+        nBuckets *= 2;
+    }
+    free(Hash.raw);
+    Hash.raw = malloc((size_t)(nBuckets * sizeof(hashBucket) + 63));
+    if (Hash.raw == NULL) {
+        Hash.buckets = NULL;
+        return false;
+    }
+    Hash.buckets = (hashBucket*)(((uintptr_t)Hash.raw + 63) & ~(uintptr_t)63);
+    Hash.mask = nBuckets - 1;
+    hashClear();
+    return true;
+}
+
+// 清空置换表
+void hashClear(void) {
+    Hash.generation = 0;
+    memset((void*)Hash.buckets, 0, (size_t)((Hash.mask + 1) * sizeof(hashBucket)));
+}
+
+// 提取置换表项，能截断时返回分值，否则返回 -MATE_VALUE；*mv 总是返回置换表中的走法
+int probeHash(positionStruct* pos, int vlAlpha, int vlBeta, int nDepth, int* mv) {
+    int i, vl, nFlag;
+    bool bMate;
+    uint64_t data;
+    hashItem* hsh;
+    hashBucket* bucket = &Hash.buckets[pos->zobrist & Hash.mask];
+
+    *mv = 0;
+    for (i = 0; i < HASH_BUCKET; i++) {
+        hsh = &bucket->items[i];
+        data = hsh->data.load(std::memory_order_relaxed);
+        nFlag = HASH_FLAG(data);
+        if ((hsh->key.load(std::memory_order_relaxed) ^ data) != pos->zobrist || nFlag == 0) {
+            continue;
+        }
+        *mv = HASH_MV(data);
+        if (nFlag == HASH_MOVE) {
+            return -MATE_VALUE;
+        }
+        // 杀棋分值要还原成相对当前节点的分值
+        bMate = false;
+        vl = HASH_VL(data);
+        if (vl > WIN_VALUE) {
+            vl -= pos->nDistance;
+            bMate = true;
+        }
+        else if (vl < -WIN_VALUE) {
+            vl += pos->nDistance;
+            bMate = true;
+        }
+        // 深度足够，或者是杀棋(与深度无关)，才能用来截断
+        if (HASH_DEPTH(data) >= nDepth || bMate) {
+            if (nFlag == HASH_BETA) {
+                return vl >= vlBeta ? vl : -MATE_VALUE;
+            }
+            else if (nFlag == HASH_ALPHA) {
+                return vl <= vlAlpha ? vl : -MATE_VALUE;
+            }
+            return vl;
+        }
+        return -MATE_VALUE;
+    }
+    return -MATE_VALUE;
+}
+
+// 保存置换表项，同一局面覆盖原项，否则替换旧代数或深度最浅的项
+void recordHash(positionStruct* pos, int nFlag, int vl, int nDepth, int mv) {
+    int i, nScore, nWorst;
+    uint64_t data, dataReplace;
+    hashItem* hsh;
+    hashItem* replace = NULL;
+    hashBucket* bucket = &Hash.buckets[pos->zobrist & Hash.mask];
+
+    // 长将、长捉判负的分值只对当时的路径成立，又低于杀棋分值，不能按步数调整，只保存走法
+    if (abs(vl) > BAN_VALUE - LIMIT_DEPTH && abs(vl) < WIN_VALUE) {
+        nFlag = HASH_MOVE;
+    }
+    if (nFlag == HASH_MOVE) {
+        if (mv == 0) {
+            return;
+        }
+        vl = 0;
+    }
+
+    nWorst = 0X7FFFFFFF;
+    dataReplace = 0;
+    for (i = 0; i < HASH_BUCKET; i++) {
+        hsh = &bucket->items[i];
+        data = hsh->data.load(std::memory_order_relaxed);
+        if ((hsh->key.load(std::memory_order_relaxed) ^ data) == pos->zobrist) {
+            // 同一局面：深度更浅的结果和只有走法的结果不覆盖，但保留更新的走法
+            if ((HASH_DEPTH(data) > nDepth && HASH_GENERATION(data) == Hash.generation) || nFlag == HASH_MOVE) {
+                if (mv != 0) {
+                    data = (data & ~(uint64_t)0XFFFF) | (uint16_t)mv;
+                    hsh->key.store(pos->zobrist ^ data, std::memory_order_relaxed);
+                    hsh->data.store(data, std::memory_order_relaxed);
+                }
+                return;
+            }
+            replace = hsh;
+            dataReplace = data;
+            break;
+        }
+        // 旧代数的项优先替换，其次是深度浅的项
+        nScore = HASH_DEPTH(data) + (HASH_GENERATION(data) == Hash.generation ? 256 : 0);
+        if (nScore < nWorst) {
+            nWorst = nScore;
+            replace = hsh;
+        }
+    }
+
+    // 杀棋分值要转换成相对根节点无关的分值
+    if (vl > WIN_VALUE) {
+        vl += pos->nDistance;
+    }
+    else if (vl < -WIN_VALUE) {
+        vl -= pos->nDistance;
+    }
+    if (mv == 0) {
+        mv = HASH_MV(dataReplace);
+    }
+    data = HASH_DATA(mv, vl, nDepth, nFlag, Hash.generation);
+    replace->key.store(pos->zobrist ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+// MVV/LVA 用的棋子价值，下标是棋子编号
+const int mvvLvaValue[7] = { 5, 1, 1, 3, 4, 3, 2 };
+
+// 吃子走法的 MVV/LVA 分值，先看被吃棋子价值，再看吃子棋子价值
+inline int MVV_LVA(positionStruct* pos, int mv) {
+    return mvvLvaValue[pos->curboard[DST(mv)] & 7] * 8 - mvvLvaValue[pos->curboard[SRC(mv)] & 7];
+}
+
+// 初始化走法排序结构
+void initSort(threadStruct* thd, moveSortStruct* sort, int mvHash) {
+    sort->mvHash = mvHash;
+    if (thd->pos.nDistance < LIMIT_DEPTH) {
+        sort->mvKiller1 = thd->mvKillers[thd->pos.nDistance][0];
+        sort->mvKiller2 = thd->mvKillers[thd->pos.nDistance][1];
+    }
+    else {
+        sort->mvKiller1 = sort->mvKiller2 = 0;
+    }
+    sort->nPhase = PHASE_HASH;
+    sort->nIndex = sort->nGenMoves = 0;
+    initPins(&thd->pos, &sort->pins);
+}
+
+// 从当前阶段剩下的走法中挑出分值最高的，没有了返回 0
+int pickMove(moveSortStruct* sort) {
+    int i, nBest, mv, vl;
+    if (sort->nIndex >= sort->nGenMoves) {
+        return 0;
+    }
+    nBest = sort->nIndex;
+    for (i = sort->nIndex + 1; i < sort->nGenMoves; i++) {
+        if (sort->vls[i] > sort->vls[nBest]) {
+            nBest = i;
+        }
+    }
+    mv = sort->mvs[nBest];
+    vl = sort->vls[nBest];
+    sort->mvs[nBest] = sort->mvs[sort->nIndex];
+    sort->vls[nBest] = sort->vls[sort->nIndex];
+    sort->mvs[sort->nIndex] = mv;
+    sort->vls[sort->nIndex] = vl;
+    sort->nIndex++;
+    return mv;
+}
+
+// 得到下一个走法，没有走法了返回 0，返回的走法都不会送将
+int nextMove(threadStruct* thd, moveSortStruct* sort) {
+    int i, mv;
+    positionStruct* pos = &thd->pos;
+    switch (sort->nPhase) {
+    // 1. 置换表走法，要检查是否合理，因为可能是键值冲突的局面留下的
+    case PHASE_HASH:
+        sort->nPhase = PHASE_CAPTURE;
+        if (sort->mvHash != 0 && legalMove(pos, sort->mvHash) && safeMove(pos, &sort->pins, sort->mvHash)) {
+            return sort->mvHash;
+        }
+        sort->mvHash = 0;
+        // 不需要 break
+
+    // 2. 生成吃子走法，按 MVV/LVA 排序
+    case PHASE_CAPTURE:
+        if (sort->nGenMoves == 0) {
+            sort->nGenMoves = generateLegalMoves(pos, &sort->pins, sort->mvs, GEN_CAPTURE);
+            for (i = 0; i < sort->nGenMoves; i++) {
+                sort->vls[i] = MVV_LVA(pos, sort->mvs[i]);
+            }
+        }
+        while ((mv = pickMove(sort)) != 0) {
+            if (mv != sort->mvHash) {
+                return mv;
+            }
+        }
+        sort->nPhase = PHASE_KILLER_1;
+        // 不需要 break
+
+    // 3. 杀手走法，必须是合理的不吃子走法
+    case PHASE_KILLER_1:
+        sort->nPhase = PHASE_KILLER_2;
+        mv = sort->mvKiller1;
+        if (mv != 0 && mv != sort->mvHash && pos->curboard[DST(mv)] == 0 && legalMove(pos, mv) &&
+            safeMove(pos, &sort->pins, mv)) {
+            return mv;
+        }
+        // 不需要 break
+
+    case PHASE_KILLER_2:
+        sort->nPhase = PHASE_QUIET;
+        mv = sort->mvKiller2;
+        if (mv != 0 && mv != sort->mvHash && pos->curboard[DST(mv)] == 0 && legalMove(pos, mv) &&
+            safeMove(pos, &sort->pins, mv)) {
+            return mv;
+        }
+        // 不需要 break
+
+    // 4. 生成不吃子走法，按历史表排序
+    case PHASE_QUIET:
+        if (sort->nPhase == PHASE_QUIET) {
+            sort->nPhase = PHASE_DONE;
+            sort->nIndex = 0;
+            sort->nGenMoves = generateLegalMoves(pos, &sort->pins, sort->mvs, GEN_QUIET);
+            for (i = 0; i < sort->nGenMoves; i++) {
+                sort->vls[i] = thd->nHistoryTable[sort->mvs[i]];
+            }
+        }
+        // 不需要 break
+
+    // 5. 逐一挑出不吃子走法
+    default:
+        while ((mv = pickMove(sort)) != 0) {
+            if (mv != sort->mvHash && mv != sort->mvKiller1 && mv != sort->mvKiller2) {
+                return mv;
+            }
+        }
+        return 0;
+    }
+}
+
+// 对最佳走法的处理：更新历史表，不吃子的 Beta 走法保存为杀手走法
+void setBestMove(threadStruct* thd, int mv, int nDepth, bool bCapture) {
+    int* lpKillers;
+    positionStruct* pos = &thd->pos;
+    thd->nHistoryTable[mv] += nDepth * nDepth;
+    if (!bCapture && pos->nDistance < LIMIT_DEPTH) {
+        lpKillers = thd->mvKillers[pos->nDistance];
+        if (lpKillers[0] != mv) {
+            lpKillers[1] = lpKillers[0];
+            lpKillers[0] = mv;
+        }
+    }
+}
+
+// 静态(Quiescence)搜索过程，只搜索吃子走法，被将军时搜索全部走法
+int searchQuiesce(threadStruct* thd, int vlAlpha, int vlBeta) {
+    int i, mv, vl, vlBest, pcCaptured, nStatus;
+    bool bRepValue;
+    moveSortStruct sort;
+    positionStruct* pos = &thd->pos;
+    // 一个静态搜索分为以下几个阶段
+
+    // 1. 达到极限深度就返回局面评价
+    countNode(thd);
+    STAT_ADD(thd, nQNodes, 1);
+    thd->bRepValue = false;
+    if (pos->nDistance >= LIMIT_DEPTH) {
+        return evaluate(pos, -MATE_VALUE, MATE_VALUE, thd->lpSearch);
+    }
+    // 重复局面直接返回和棋或者长将、长捉判负的分值
+    nStatus = repStatus(pos);
+    if (nStatus != REP_NONE) {
+        thd->bRepValue = true;
+        return repValue(pos, nStatus);
+    }
+
+    // 2. 初始化最佳值
+    vlBest = -MATE_VALUE;  // 这样可以知道，是否一个走法都没走过(杀棋)
+    bRepValue = false;
+
+    // 是否被将军取自历史走法栈，不用再判断
+    initPins(pos, &sort.pins);
+    if (sort.pins.bInCheck) {
+        // 3. 如果被将军，则生成全部走法，吃子走法按 MVV/LVA 排在前面，其余按历史表排序
+        sort.nGenMoves = generateLegalMoves(pos, &sort.pins, sort.mvs, GEN_ALL);
+        for (i = 0; i < sort.nGenMoves; i++) {
+            mv = sort.mvs[i];
+            sort.vls[i] = pos->curboard[DST(mv)] != 0 ? 0X40000000 + MVV_LVA(pos, mv) :
+                          thd->nHistoryTable[mv];
+        }
+    }
+    else {
+        // 4. 如果不被将军，先做局面评价，局面评价已经超出 Beta 就截断
+        vl = evaluate(pos, vlAlpha, vlBeta, thd->lpSearch);
+        if (vl > vlBest) {
+            vlBest = vl;
+            if (vl >= vlBeta) {
+                return vl;
+            }
+            if (vl > vlAlpha) {
+                vlAlpha = vl;
+            }
+        }
+
+        // 5. 如果局面评价没有截断，再生成吃子走法，按 MVV/LVA 排序
+        sort.nGenMoves = generateLegalMoves(pos, &sort.pins, sort.mvs, GEN_CAPTURE);
+        for (i = 0; i < sort.nGenMoves; i++) {
+            sort.vls[i] = MVV_LVA(pos, sort.mvs[i]);
+        }
+    }
+
+    // 6. 逐一走这些走法，并进行递归
+    sort.nIndex = 0;
+    while ((mv = pickMove(&sort)) != 0) {
+        makeLegalMove(pos, mv, &pcCaptured);
+        vl = -searchQuiesce(thd, -vlBeta, -vlAlpha);
+        undoMakeMove(pos, mv, pcCaptured);
+        if (searchStopped(thd)) {
+            return 0;
+        }
+
+        // 7. 进行Alpha-Beta大小判断和截断，截断时 thd->bRepValue 就是这个走法的
+        if (vl > vlBest) {
+            vlBest = vl;
+            if (vl >= vlBeta) {
+                return vl;
+            }
+            if (vl > vlAlpha) {
+                vlAlpha = vl;
+            }
+        }
+        bRepValue = bRepValue || thd->bRepValue;
+    }
+
+    // 8. 所有走法都搜索完了，返回最佳值
+    thd->bRepValue = bRepValue;
+    return vlBest == -MATE_VALUE ? pos->nDistance - MATE_VALUE : vlBest;
+}
+
+// 超出边界(Fail-Soft)的Alpha-Beta搜索过程
+int searchFull(threadStruct* thd, int vlAlpha, int vlBeta, int nDepth, bool bNoNull) {
+    int mv, pcCaptured, pcBest, nMoves, nReduction, nStatus;
+    int vl, vlBest, mvBest, mvHash;
+    bool bInCheck, bRepValue;
+    moveSortStruct sort;
+    positionStruct* pos = &thd->pos;
+    // 一个Alpha-Beta完全搜索分为以下几个阶段
+
+    // 1. 到达水平线，则调用静态搜索
+    if (nDepth <= 0) {
+        return searchQuiesce(thd, vlAlpha, vlBeta);
+    }
+    countNode(thd);
+    // 重复局面直接返回和棋或者长将、长捉判负的分值，不再往下搜。
+    // 这样的分值只对当前路径成立，用 thd->bRepValue 告诉上一层：受它影响的分值不能保存到置换表
+    thd->bRepValue = false;
+    if (pos->nDistance > 0) {
+        nStatus = repStatus(pos);
+        if (nStatus != REP_NONE) {
+            thd->bRepValue = true;
+            return repValue(pos, nStatus);
+        }
+    }
+
+    // 2. 尝试置换表截断，根节点要得到最佳走法，所以不截断
+    vl = probeHash(pos, vlAlpha, vlBeta, nDepth, &mvHash);
+    STAT_ADD(thd, nHashProbes, 1);
+    STAT_ADD(thd, nHashHits, vl > -MATE_VALUE || mvHash != 0);
+    if (vl > -MATE_VALUE && pos->nDistance > 0) {
+        return vl;
+    }
+    // 残局库里有这个子力组合，就直接返回精确的分值
+    if (pos->nDistance > 0 && egtbProbe(pos, &vl)) {
+        return vl;
+    }
+
+    // 3. 空着裁剪：让对方连走两步，减少 NULL_DEPTH 层的零窗口搜索仍然超过 Beta 就截断。
+    //    根节点、连续空着、被将军、杀棋窗口和进攻子力不足时都不做
+    bInCheck = pos->moveStack[pos->nMoveNum - 1].bCheck;
+    if (thd->lpSearch->bNullMove && !bNoNull && pos->nDistance > 0 && vlBeta > -WIN_VALUE &&
+        vlBeta < WIN_VALUE && !bInCheck && nullOkay(pos)) {
+        makeNullMove(pos);
+        vl = -searchFull(thd, -vlBeta, 1 - vlBeta, nDepth - NULL_DEPTH - 1, true);
+        undoMakeNullMove(pos);
+        if (searchStopped(thd)) {
+            return 0;
+        }
+        // 验证搜索：不走空着，用同样减少的深度再搜索一次，也超过 Beta 才截断
+        if (vl >= vlBeta && thd->lpSearch->bNullVerify) {
+            vl = searchFull(thd, vlBeta - 1, vlBeta, nDepth - NULL_DEPTH, true);
+            if (searchStopped(thd)) {
+                return 0;
+            }
+        }
+        // 空着搜索出的杀棋并不可靠，只返回 Beta
+        if (vl >= vlBeta) {
+            return vl > WIN_VALUE ? vlBeta : vl;
+        }
+    }
+
+    // 4. 初始化最佳值和最佳走法
+    vlBest = -MATE_VALUE;  // 这样可以知道，是否一个走法都没走过(杀棋)
+    mvBest = 0;  // 这样可以知道，是否搜索到了Beta走法或PV走法，以便保存到历史表
+    bRepValue = false;  // Beta 截断时只看截断的走法，否则看所有走法
+
+    // 5. 初始化走法排序结构，按阶段逐步生成走法
+    pcBest = 0;
+    initSort(thd, &sort, mvHash);
+
+    // 6. 逐一走这些走法，并进行递归
+    nMoves = 0;
+    while ((mv = nextMove(thd, &sort)) != 0) {
+        makeLegalMove(pos, mv, &pcCaptured);
+        nMoves++;
+        if (vlBest == -MATE_VALUE) {
+            vl = -searchFull(thd, -vlBeta, -vlAlpha, nDepth - 1);
+        }
+        else {
+            // 后期走法减少深度(LMR)：排在历史表后面的不吃子走法，不被将军也不将军对方时，
+            // 按深度和走法序号查表减少深度，用零窗口搜索，超过 Alpha 才按原深度重新搜索
+            nReduction = 0;
+            if (thd->lpSearch->bLmr && !bInCheck && pcCaptured == 0 && sort.nPhase == PHASE_DONE &&
+                nDepth >= LMR_DEPTH && nMoves >= LMR_MOVES &&
+                !pos->moveStack[pos->nMoveNum - 1].bCheck) {
+                nReduction = lmrTable[nDepth < LIMIT_DEPTH ? nDepth : LIMIT_DEPTH - 1]
+                                     [nMoves < MAX_GEN_MOVES ? nMoves : MAX_GEN_MOVES - 1];
+                // 历史表分值高的走法少减一层
+                if (thd->nHistoryTable[mv] > nDepth * nDepth) {
+                    nReduction--;
+                }
+                nReduction = nReduction < nDepth - 2 ? nReduction : nDepth - 2;
+            }
+            if (nReduction > 0) {
+                vl = -searchFull(thd, -vlAlpha - 1, -vlAlpha, nDepth - 1 - nReduction);
+                thd->nLmrReduced++;
+                thd->nLmrPlies += nReduction;
+                if (vl > vlAlpha) {
+                    thd->nLmrResearched++;
+                }
+            }
+            if (nReduction <= 0 || vl > vlAlpha) {
+                // 主要变例搜索：先用零窗口证明不超过 Alpha，超过 Alpha 并且没有超过 Beta 时，
+                // 才用完整的窗口重新搜索
+                if (thd->lpSearch->bPvs) {
+                    vl = -searchFull(thd, -vlAlpha - 1, -vlAlpha, nDepth - 1);
+                    if (vl > vlAlpha && vl < vlBeta) {
+                        vl = -searchFull(thd, -vlBeta, -vlAlpha, nDepth - 1);
+                    }
+                }
+                else {
+                    vl = -searchFull(thd, -vlBeta, -vlAlpha, nDepth - 1);
+                }
+            }
+        }
+        undoMakeMove(pos, mv, pcCaptured);
+        // 搜索被中止，分值已经不可靠，不能保存到历史表和置换表
+        if (searchStopped(thd)) {
+            return 0;
+        }
+
+        // 7. 进行Alpha-Beta大小判断和截断
+        if (vl > vlBest) {  // 找到最佳值(但不能确定是Alpha、PV还是Beta走法)
+            vlBest = vl;  // "vlBest"就是目前要返回的最佳值，可能超出Alpha-Beta边界
+            if (vl >= vlBeta) {   // 找到一个Beta走法
+                mvBest = mv;      // Beta走法要保存到历史表
+                pcBest = pcCaptured;
+                STAT_ADD(thd, nBetaCuts, 1);
+                STAT_ADD(thd, nFirstCuts, nMoves == 1);
+                bRepValue = thd->bRepValue;
+                break;            // Beta截断
+            }
+            if (vl > vlAlpha) {   // 找到一个PV走法
+                mvBest = mv;      // PV走法要保存到历史表
+                pcBest = pcCaptured;
+                vlAlpha = vl;     // 缩小Alpha-Beta边界
+            }
+        }
+        bRepValue = bRepValue || thd->bRepValue;
+    }
+
+    // 8. 所有走法都搜索完了，把最佳走法(不能是Alpha走法)保存到历史表和置换表，返回最佳值；
+    //    分值受重复局面影响时只保存走法
+    thd->bRepValue = bRepValue;
+    if (vlBest == -MATE_VALUE) {
+        // 如果是杀棋，就根据杀棋步数给出评价
+        return pos->nDistance - MATE_VALUE;
+    }
+    recordHash(pos, bRepValue ? HASH_MOVE : vlBest >= vlBeta ? HASH_BETA : (mvBest != 0 ? HASH_PV : HASH_ALPHA),
+               vlBest, nDepth, mvBest);
+    if (mvBest != 0) {
+        // 如果不是Alpha走法，就将最佳走法保存到历史表和杀手走法表
+        setBestMove(thd, mvBest, nDepth, pcBest != 0);
+        if (pos->nDistance == 0) {
+            // 搜索根节点时，总是有一个最佳走法(因为全窗口搜索不会超出边界)，将这个走法保存下来
+            thd->mvResult = mvBest;
+        }
+    }
+    return vlBest;
+}
+
+#ifdef SEARCH_STATS
+// 写一行 JSON 统计：lpStats 是这一段搜索的计数，tSpan 是这一段的用时，dEbf 是有效分支因子
+void writeStats(searchStruct* lpSearch, const char* szType, int nDepth, int64_t tSpan,
+                const statStruct* lpStats, double dEbf) {
+    char szMove[5];
+    moveToStr(lpSearch->mvResult, szMove);
+    fprintf(lpSearch->fpStats, "{\"type\":\"%s\",\"depth\":%d,\"score\":%d,\"move\":\"%s\","
+            "\"threads\":%d,\"time\":%lld,\"span_time\":%lld,\"nodes\":%lld,\"qnodes\":%lld,"
+            "\"nps\":%lld,\"ebf\":%.2f,\"first_cut\":%.3f,\"hash_hit\":%.3f}\n", szType, nDepth,
+            lpSearch->vlResult, lpSearch->mvResult == 0 ? "none" : szMove, lpSearch->nThreads,
+            (long long)(searchClock() - lpSearch->tStart), (long long)tSpan, (long long)lpStats->nNodes,
+            (long long)lpStats->nQNodes, (long long)(lpStats->nNodes * 1000 / (tSpan > 0 ? tSpan : 1)),
+            dEbf, lpStats->nBetaCuts > 0 ? (double)lpStats->nFirstCuts / lpStats->nBetaCuts : 0.0,
+            lpStats->nHashProbes > 0 ? (double)lpStats->nHashHits / lpStats->nHashProbes : 0.0);
+    fflush(lpSearch->fpStats);
+}
+
+// 主线程完成第 nDepth 次迭代后调用，统计的是这次迭代主线程的计数，
+// 有效分支因子是这次迭代和上一次迭代的节点数之比
+void writeIterStats(searchStruct* lpSearch, threadStruct* thd, int nDepth) {
+    statStruct st;
+    thd->stats.nNodes = thd->nNodes;
+    st.nNodes = thd->stats.nNodes - lpSearch->statLast.nNodes;
+    st.nQNodes = thd->stats.nQNodes - lpSearch->statLast.nQNodes;
+    st.nHashProbes = thd->stats.nHashProbes - lpSearch->statLast.nHashProbes;
+    st.nHashHits = thd->stats.nHashHits - lpSearch->statLast.nHashHits;
+    st.nBetaCuts = thd->stats.nBetaCuts - lpSearch->statLast.nBetaCuts;
+    st.nFirstCuts = thd->stats.nFirstCuts - lpSearch->statLast.nFirstCuts;
+    if (lpSearch->fpStats != NULL) {
+        writeStats(lpSearch, "iter", nDepth,
+                   lpSearch->nDepthTime[nDepth] - (nDepth > 1 ? lpSearch->nDepthTime[nDepth - 1] : 0), &st,
+                   lpSearch->nIterNodes > 0 ? (double)st.nNodes / lpSearch->nIterNodes : 0.0);
+    }
+    lpSearch->statLast = thd->stats;
+    lpSearch->nIterNodes = st.nNodes;
+}
+
+// 搜索结束、所有线程停下后调用，统计的是所有线程的计数，有效分支因子是节点数的深度次方根
+void writeSearchStats(searchStruct* lpSearch) {
+    int i;
+    statStruct st;
+    threadStruct* thd;
+    if (lpSearch->fpStats == NULL) {
+        return;
+    }
+    memset(&st, 0, sizeof(statStruct));
+    for (i = 0; i < lpSearch->nThreads; i++) {
+        thd = &lpSearch->threads[i];
+        st.nNodes += thd->nNodes;
+        st.nQNodes += thd->stats.nQNodes;
+        st.nHashProbes += thd->stats.nHashProbes;
+        st.nHashHits += thd->stats.nHashHits;
+        st.nBetaCuts += thd->stats.nBetaCuts;
+        st.nFirstCuts += thd->stats.nFirstCuts;
+    }
+    writeStats(lpSearch, "search", lpSearch->nDepthResult, searchClock() - lpSearch->tStart, &st,
+               lpSearch->nDepthResult > 0 ? pow((double)st.nNodes, 1.0 / lpSearch->nDepthResult) : 0.0);
+}
+#endif
+
+// 预测对方的应着：走完 mv 后置换表里的走法，不合法就返回 0
+int ponderMove(positionStruct* pos, int mv) {
+    int mvPonder, pcCaptured, pcPonder;
+    if (mv == 0 || !makeMove(pos, mv, &pcCaptured)) {
+        return 0;
+    }
+    probeHash(pos, -MATE_VALUE, MATE_VALUE, 0, &mvPonder);
+    if (mvPonder != 0 && legalMove(pos, mvPonder) && makeMove(pos, mvPonder, &pcPonder)) {
+        undoMakeMove(pos, mvPonder, pcPonder);
+    }
+    else {
+        mvPonder = 0;
+    }
+    undoMakeMove(pos, mv, pcCaptured);
+    return mvPonder;
+}
+
+// 辅助线程的迭代加深：和主线程搜索同一个局面，结果只通过共享的置换表帮助主线程。
+// 奇数号线程从深一层开始，和偶数号线程错开深度，减少重复的搜索
+void searchHelper(threadStruct* thd, int nMaxDepth) {
+    int i;
+    for (i = 1 + (thd->nThread & 1); i <= nMaxDepth; i++) {
+        searchFull(thd, -MATE_VALUE, MATE_VALUE, i);
+        if (searchStopped(thd)) {
+            break;
+        }
+    }
+}
+
+// 迭代加深搜索过程，受 lpSearch 中的深度、时间和节点数限制，结果也写在 lpSearch 中。
+// 多线程时采用 Lazy SMP：辅助线程各自搜索，主线程的结果作为最终结果。
+// 不同的 lpSearch 可以在不同的线程中同时搜索各自的局面，只共用置换表。
+// 开始前设置 lpSearch->bPonder 就是后台思考，在预测的局面上先搜索，命中后才开始计时
+void searchMain(searchStruct* lpSearch, positionStruct* lpPos) {
+    int i, j, vl, vlAlpha, vlBeta, nWindow, nMaxDepth, nGenMoves, pcCaptured;
+    int mvs[MAX_GEN_MOVES];
+    threadStruct* thd;
+    std::thread helpers[MAX_THREADS];
+
+    // 初始化
+    lpSearch->mvResult = 0;
+    lpSearch->vlResult = 0;
+    lpSearch->nDepthResult = 0;
+    lpSearch->nNodes = 0;
+    lpSearch->nLmrReduced = lpSearch->nLmrPlies = lpSearch->nLmrResearched = 0;
+    if (lpSearch->threads == NULL && !threadsInit(1, lpSearch)) {
+        return;
+    }
+    Hash.generation++;                // 置换表进入新的一代，旧的项优先被替换
+    lpSearch->tStart = searchClock(); // 初始化定时器
+    lpSearch->bTimeout = false;
+    allocateTime(lpSearch);
+    lpPos->nDistance = 0;             // 初始步数
+    nMaxDepth = lpSearch->nMaxDepth > 0 && lpSearch->nMaxDepth < LIMIT_DEPTH ?
+                lpSearch->nMaxDepth : LIMIT_DEPTH;
+    for (i = 0; i < lpSearch->nThreads; i++) {
+        thd = &lpSearch->threads[i];
+        thd->pos = *lpPos;                                    // 每个线程有自己的局面
+        thd->mvResult = 0;
+        thd->nNodes = 0;
+        thd->nLmrReduced = thd->nLmrPlies = thd->nLmrResearched = 0;
+        if (lpSearch->bWarmHistory) {
+            // 上一次后台思考的局面和这次只差两步，历史表还有参考价值，缩小后保留
+            for (j = 0; j < 65536; j++) {
+                thd->nHistoryTable[j] /= 4;
+            }
+        }
+        else {
+            memset(thd->nHistoryTable, 0, 65536 * sizeof(int));  // 清空历史表
+        }
+        memset(thd->mvKillers, 0, sizeof(thd->mvKillers));   // 清空杀手走法表
+#ifdef SEARCH_STATS
+        memset(&thd->stats, 0, sizeof(statStruct));
+#endif
+    }
+#ifdef SEARCH_STATS
+    memset(&lpSearch->statLast, 0, sizeof(statStruct));
+    lpSearch->nIterNodes = 0;
+#endif
+
+    // 启动辅助线程
+    lpSearch->bHelperStop = false;
+    for (i = 1; i < lpSearch->nThreads; i++) {
+        helpers[i] = std::thread(searchHelper, &lpSearch->threads[i], nMaxDepth);
+    }
+
+    // 主线程的迭代加深过程
+    thd = &lpSearch->threads[0];
+    vl = 0;
+    for (i = 1; i <= nMaxDepth; i++) {
+        // 期望窗口：以上一次迭代的分值为中心，落在窗口外就向失败的一侧放宽，直到落在窗口内；
+        // 失败的一侧已经是杀棋分值的边界时不能再放宽(例如没有合法走法)，这时的分值就是结果
+        nWindow = ASPIRATION_WINDOW;
+        vlAlpha = -MATE_VALUE;
+        vlBeta = MATE_VALUE;
+        if (lpSearch->bAspiration && i > 1 && vl > -WIN_VALUE && vl < WIN_VALUE) {
+            vlAlpha = vl - nWindow;
+            vlBeta = vl + nWindow;
+        }
+        for (;;) {
+            vl = searchFull(thd, vlAlpha, vlBeta, i);
+            if (searchStopped(thd) || (vl > vlAlpha && vl < vlBeta) ||
+                (vl <= vlAlpha && vlAlpha == -MATE_VALUE) || (vl >= vlBeta && vlBeta == MATE_VALUE)) {
+                break;
+            }
+            nWindow *= 4;
+            if (vl <= vlAlpha) {
+                vlAlpha = vl - nWindow < -WIN_VALUE ? -MATE_VALUE : vl - nWindow;
+            }
+            else {
+                vlBeta = vl + nWindow > WIN_VALUE ? MATE_VALUE : vl + nWindow;
+            }
+        }
+        // 中途被停止，这次迭代的结果作废，"mvResult"保留上一次迭代的走法
+        if (searchStopped(thd)) {
+            LOG("stopped, searching stoped!\n");
+            break;
+        }
+        lpSearch->mvResult = thd->mvResult;
+        lpSearch->vlResult = vl;
+        lpSearch->nDepthResult = i;
+        lpSearch->mvDepth[i] = thd->mvResult;
+        lpSearch->nDepthTime[i] = (int)(searchClock() - lpSearch->tStart);
+        lpSearch->nDepthNodes[i] = thd->nNodes;
+#ifdef SEARCH_STATS
+        writeIterStats(lpSearch, thd, i);
+#endif
+        // 搜索到杀棋，就终止搜索
+        if (vl > WIN_VALUE || vl < -WIN_VALUE) {
+            break;
+        }
+        // 超过分配的时间，就不再开始新一次迭代
+        if (lpSearch->nSoftTime != 0 && !lpSearch->bPonder &&
+            searchClock() - lpSearch->tStart >= lpSearch->nSoftTime) {
+            LOG("timeout, searching stoped!\n");
+            break;
+        }
+    }
+
+    // 后台思考或者无限思考时搜索完了也不能给出结果，等到命中或者停止
+    ponderWait(lpSearch);
+
+    // 停止辅助线程，统计节点数
+    lpSearch->bHelperStop = true;
+    for (i = 0; i < lpSearch->nThreads; i++) {
+        if (i > 0) {
+            helpers[i].join();
+        }
+        lpSearch->nNodes += lpSearch->threads[i].nNodes;
+        lpSearch->nLmrReduced += lpSearch->threads[i].nLmrReduced;
+        lpSearch->nLmrPlies += lpSearch->threads[i].nLmrPlies;
+        lpSearch->nLmrResearched += lpSearch->threads[i].nLmrResearched;
+    }
+#ifdef SEARCH_STATS
+    writeSearchStats(lpSearch);
+#endif
+
+    // 第一次迭代都没完成就被停止了，随便给出一个合法走法
+    if (lpSearch->mvResult == 0) {
+        nGenMoves = generateMoves(lpPos, mvs);
+        for (i = 0; i < nGenMoves; i++) {
+            if (makeMove(lpPos, mvs[i], &pcCaptured)) {
+                undoMakeMove(lpPos, mvs[i], pcCaptured);
+                lpSearch->mvResult = mvs[i];
+                break;
+            }
+        }
+    }
+    lpSearch->mvPonder = ponderMove(lpPos, lpSearch->mvResult);
+
+    // 没有命中就停止的后台思考，下一次搜索保留一部分历史表
+    lpSearch->bWarmHistory = lpSearch->bPonder;
+    lpSearch->bPonder = false;
+    lpSearch->bInfinite = false;
+    LOG("search depth: %d\n", lpSearch->nDepthResult);
+}
+
+void ponderHit(searchStruct* lpSearch) {
+    lpSearch->tStart = searchClock();
+    lpSearch->bPonder = false;
+}
+
+void ponderWait(searchStruct* lpSearch) {
+    while ((lpSearch->bPonder || lpSearch->bInfinite) && !lpSearch->bStop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void startup(positionStruct* pos) {  // 初始化棋盘
+    int id;
+    clearBoard(pos);
+    // 逐个放置棋子，同时计算子力价值和 Zobrist 键值
+    for (id = 0; id < 256; id++) {
+        if (boardStartup[id] != 0) {
+            addPiece(pos, id, boardStartup[id]);
+        }
+    }
+    setIrreversible(pos);
+}
+
+// FEN 串中的棋子字母，红方大写，黑方小写，顺序与棋子编号一致
+const char fenPieces[] = "KABNRCP";
+
+// 由 FEN 串初始化局面，只识别棋盘和走子方两部分
+bool fromFen(positionStruct* pos, const char* szFen) {
+    int x, y, type;
+    const char* p = szFen;
+    const char* lpPiece;
+
+    clearBoard(pos);
+
+    // 1. 棋盘，从黑方底线(RANK_TOP)开始，每行用 '/' 隔开
+    x = FILE_LEFT;
+    y = RANK_TOP;
+    for (; *p != '\0' && *p != ' '; p++) {
+        if (*p == '/') {
+            x = FILE_LEFT;
+            y++;
+            if (y > RANK_BOTTOM) {
+                return false;
+            }
+        }
+        else if (*p >= '1' && *p <= '9') {
+            x += *p - '0';
+        }
+        else {
+            if (*p >= 'A' && *p <= 'Z') {
+                lpPiece = strchr(fenPieces, *p);
+                type = SIDE_TAG(0);
+            }
+            else {
+                lpPiece = strchr(fenPieces, *p - 'a' + 'A');
+                type = SIDE_TAG(1);
+            }
+            // 识别 "B"/"E"、"N"/"H" 两种常见写法
+            if (*p == 'E' || *p == 'e') {
+                lpPiece = fenPieces + PIECE_BISHOP;
+            }
+            else if (*p == 'H' || *p == 'h') {
+                lpPiece = fenPieces + PIECE_KNIGHT;
+            }
+            if (lpPiece == NULL || *lpPiece == '\0' || x > FILE_RIGHT ||
+                pos->nPieces[SIDE_INDEX(type)] == 16) {
+                return false;
+            }
+            addPiece(pos, COORD_XY(x, y), type + (int)(lpPiece - fenPieces));
+            x++;
+        }
+    }
+
+    // 2. 走子方，"b" 表示黑方，"w" 或 "r" 表示红方
+    while (*p == ' ') {
+        p++;
+    }
+    if (*p == 'b') {
+        changeSide(pos);
+    }
+    setIrreversible(pos);
+    return true;
+}
+
+// 把 ICCS 坐标格式的走法(如 "h2e2")转换成走法，格式不对返回 0
+int strToMove(const char* str) {
+    int idSrc, idDst;
+    if (str[0] < 'a' || str[0] > 'i' || str[1] < '0' || str[1] > '9' ||
+        str[2] < 'a' || str[2] > 'i' || str[3] < '0' || str[3] > '9') {
+        return 0;
+    }
+    idSrc = COORD_XY(FILE_LEFT + str[0] - 'a', RANK_BOTTOM - (str[1] - '0'));
+    idDst = COORD_XY(FILE_LEFT + str[2] - 'a', RANK_BOTTOM - (str[3] - '0'));
+    return MOVE(idSrc, idDst);
+}
+
+// 把走法转换成 ICCS 坐标格式，str 至少 5 个字节
+void moveToStr(int mv, char* str) {
+    str[0] = (char)('a' + X(SRC(mv)) - FILE_LEFT);
+    str[1] = (char)('0' + RANK_BOTTOM - Y(SRC(mv)));
+    str[2] = (char)('a' + X(DST(mv)) - FILE_LEFT);
+    str[3] = (char)('0' + RANK_BOTTOM - Y(DST(mv)));
+    str[4] = '\0';
+}
@@ -0,0 +1,534 @@
+#ifndef LVENW_ENGINE_H
+#define LVENW_ENGINE_H
+
+// 引擎部分：局面表示、走法生成、搜索，不依赖任何界面库
+
+#include <stdlib.h>         // atoi
+#include <stdint.h>         // uint64_t
+#include <string.h>         // memcpy
+#include <stdbool.h>        // bool
+#include <atomic>           // 停止搜索的标志，可能由其他线程设置
+
+#ifdef _MSC_VER
+#include <intrin.h>         // _BitScanForward64
+#endif
+
+// #define USE_BITBOARD     // 使用位棋盘生成走法，见 bitboard.h
+// #define USE_NNUE         // 可以用神经网络评价，见 nnue.h
+// #define COMPACT_TABLES   // 紧凑的表布局：格子属性合并成一个字节，子力位置价值用 16 位，见 compactStruct
+
+// #define NDEBUG           // turn off debug
+#include <assert.h>         // assert
+
+#ifdef NDEBUG
+#define LOG(fmt, ...)
+#else   //  stderr log，避免干扰 UCCI 协议的标准输出
+#include <stdio.h>
+#define LOG(fmt, ...)  fprintf(stderr, "[%s %s %d]\033[31m" fmt"\033[0m", __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
+#endif
+
+
+// 棋盘范围
+#define RANK_TOP        3
+#define RANK_BOTTOM     12
+#define FILE_LEFT       3
+#define FILE_RIGHT      11
+
+// 棋子编号
+#define PIECE_KING        0    // 将
+#define PIECE_ADVISOR     1    // 仕
+#define PIECE_BISHOP      2    // 相
+#define PIECE_KNIGHT      3    // 马
+#define PIECE_ROOK        4    // 车
+#define PIECE_CANNON      5    // 炮
+#define PIECE_PAWN        6    // 兵
+
+
+#define MAX_GEN_MOVES   128                 // 最大的生成走法数
+#define LIMIT_DEPTH     32                  // 最大的搜索深度
+#define MATE_VALUE      10000               // 最高分值，即将死的分值
+#define WIN_VALUE       (MATE_VALUE - 100)  // 搜索出胜负的分值界限，超出此值就说明已经搜索出杀棋了
+#define BAN_VALUE       (WIN_VALUE - 100)   // 长将、长捉判负的分值，低于杀棋分值，不按杀棋处理
+#define MAX_MOVE_NUM    1024                // 历史走法栈的大小，对局中的走法加上搜索的步数
+#define ADVANCED_VALUE  3                   // 先行权分值
+#define HASH_SIZE_MB    16                  // 置换表默认大小(MB)，启动时可通过命令行参数修改
+#define HASH_BUCKET     4                   // 每个桶的项数，一个桶正好占一条缓存行
+#define MAX_THREADS     64                  // 最多的搜索线程数
+#define ASPIRATION_WINDOW  16               // 期望窗口的初始半宽
+#define NULL_DEPTH      2                   // 空着裁剪减少的深度
+#define NULL_MATERIAL   6                   // 空着裁剪要求的最少进攻子力，见 nullOkay
+#define LMR_DEPTH       3                   // 剩余深度至少这么多才做后期走法减少深度
+#define LMR_MOVES       4                   // 从第几个走法开始减少深度
+
+// 局面评价的附加项，见 evaluate
+#define KING_SHIELD_VALUE   3               // 对方每个过河的进攻子力，按缺少的仕(士)、相(象)数扣分，车算两个
+#define HOLLOW_CANNON_VALUE 20              // 空头炮：对方的炮和帅(将)在同一列，中间没有棋子
+#define PAWN_CHAIN_VALUE    6               // 过河后左右相连的一对兵(卒)
+#define ROOK_MOBILITY       1               // 车每多一个能走的空格
+#define KNIGHT_MOBILITY     3               // 马每多一个能走的格子
+#define CANNON_MOBILITY     1               // 炮每多两个能走的空格
+#define KNIGHT_CANNON_VALUE 12              // 马和炮都过河
+#define LAZY_MARGIN_1       120             // 默认的第一层余量，应不小于第二、三层分值之和的绝对值，见 benchEval
+#define LAZY_MARGIN_2       64              // 默认的第二层余量，应不小于第三层分值的绝对值
+#define POLL_NODES      1024                // 主线程每搜索这么多节点检查一次时间，必须是 2 的幂
+#define MOVES_TO_GO     30                  // 不知道到加时还要走几步时，按这么多步分配棋钟时间
+#define TIME_MARGIN     50                  // 棋钟时间留出的余量(毫秒)，防止通信延迟超时
+
+// 生成走法的类型
+#define GEN_CAPTURE     1                   // 吃子走法
+#define GEN_QUIET       2                   // 不吃子走法
+#define GEN_ALL         3                   // 全部走法
+
+// 走法排序的阶段
+#define PHASE_HASH      0                   // 置换表走法
+#define PHASE_CAPTURE   1                   // 吃子走法，按 MVV/LVA 排序
+#define PHASE_KILLER_1  2                   // 杀手走法
+#define PHASE_KILLER_2  3
+#define PHASE_QUIET     4                   // 不吃子走法，按历史表排序
+#define PHASE_DONE      5
+
+// 置换表项的类型
+#define HASH_ALPHA      1                   // 上界，所有走法都没超过 Alpha
+#define HASH_BETA       2                   // 下界，发生了 Beta 截断
+#define HASH_PV         3                   // 精确值
+#define HASH_MOVE       4                   // 只有走法：分值来自重复局面，只对当时的路径成立，不能用来截断
+
+
+extern const char inBoard[256];             // 判断棋子是否在棋盘中的数组
+extern const char inFort[256];              // 判断棋子是否在九宫的数组
+extern const char legalSpan[512];           // 判断步长是否符合特定走法的数组
+extern const char knightPin[512];           // 根据步长判断马是否蹩腿的数组
+extern const char kingDelta[4];             // 帅(将)的步长
+extern const char advisorDelta[4];          // 仕(士)的步长
+extern const char knightDelta[4][2];        // 马的步长
+extern const char knightCheckDelta[4][2];   // 马被将军的步长
+extern const char boardStartup[256];        // 棋盘初始设置
+extern const int  cucvlPiecePos[7][256];    // 子力位置价值表
+
+#ifdef COMPACT_TABLES
+// 紧凑的表布局，搜索时查的小表放在一起，由 engine.cpp 用上面的表在编译时生成
+#define SQUARE_BOARD    1                   // 格子属性：在棋盘中
+#define SQUARE_FORT     2                   // 格子属性：在九宫中
+#define PIECE_POS_BASE  (RANK_TOP << 4)     // 子力位置价值只保存棋盘所在的行，从这个格子开始
+#define PIECE_POS_SIZE  ((RANK_BOTTOM - RANK_TOP + 1) << 4)
+
+// 一种步长的走法类型和马腿，合并 legalSpan 和 knightPin
+typedef struct spanItem {
+    char span;                  // 1 是帅(将)，2 是仕(士)，3 是相(象)，其他是 0
+    char pin;                   // 马腿的步长，不是马的走法时是 0
+} spanItem;
+
+typedef struct compactStruct {
+    unsigned char squareFlags[256];                     // SQUARE_BOARD、SQUARE_FORT 的组合
+    spanItem spans[512];                                // 下标是步长 + 256
+    int16_t vlPiecePos[7][PIECE_POS_SIZE];              // 下标是格子 - PIECE_POS_BASE
+} compactStruct;
+
+extern const compactStruct Compact;
+#endif
+
+// 判断棋子是否在棋盘中
+inline bool IN_BOARD(int id) {
+#ifdef COMPACT_TABLES
+    return (Compact.squareFlags[id] & SQUARE_BOARD) != 0;
+#else
+    return inBoard[id] != 0;
+#endif
+}
+
+// 判断棋子是否在九宫中
+inline bool IN_FORT(int id) {
+#ifdef COMPACT_TABLES
+    return (Compact.squareFlags[id] & SQUARE_FORT) != 0;
+#else
+    return inFort[id] != 0;
+#endif
+}
+
+// 纵坐标，除以 16，即行数
+inline int   Y(int id) { return id >> 4; }
+inline int ROW(int id) { return id >> 4; }
+
+// 横坐标，16 取余，获得本行偏移，即列数
+inline int   X(int id) { return id & 0XF; }
+inline int COL(int id) { return id & 0XF; }
+
+// 根据纵坐和横坐标获得格子
+inline int COORD_XY(int x, int y) { return x + (y << 4); }
+
+// 翻转格子
+inline int SQUARE_FLIP(int sq) { return 254 - sq; }
+
+// 纵坐标水平镜像
+inline int FILE_FLIP(int x) { return 14 - x; }
+
+// 横坐标垂直镜像
+inline int RANK_FLIP(int y) { return 15 - y; }
+
+// 格子水平镜像
+inline int MIRROR_SQUARE(int id) {
+    return COORD_XY(FILE_FLIP(X(id)), Y(id));
+}
+
+// 兵卒前进一步
+inline int SQUARE_FORWARD(int id, int isBlack) { return id - 16 + (isBlack << 5); }
+
+// 走法的步长符合哪种棋子，见 legalSpan
+inline int SPAN_TYPE(int idSrc, int idDst) {
+#ifdef COMPACT_TABLES
+    return Compact.spans[idDst - idSrc + 256].span;
+#else
+    return legalSpan[idDst - idSrc + 256];
+#endif
+}
+
+// 走法是否符合帅(将)的步长
+inline bool KING_SPAN(int idSrc, int idDst) {
+    return SPAN_TYPE(idSrc, idDst) == 1;
+}
+
+// 走法是否符合仕(士)的步长
+inline bool ADVISOR_SPAN(int idSrc, int idDst) {
+    return SPAN_TYPE(idSrc, idDst) == 2;
+}
+
+// 走法是否符合相(象)的步长
+inline bool BISHOP_SPAN(int idSrc, int idDst) {
+    return SPAN_TYPE(idSrc, idDst) == 3;
+}
+
+// 相(象)眼的位置
+inline int BISHOP_PIN(int idSrc, int idDst) { return (idSrc + idDst) >> 1; }
+
+// 马腿的位置
+inline int KNIGHT_PIN(int idSrc, int idDst) {
+#ifdef COMPACT_TABLES
+    return idSrc + Compact.spans[idDst - idSrc + 256].pin;
+#else
+    return idSrc + knightPin[idDst - idSrc + 256];
+#endif
+}
+
+// 是否未过河
+inline bool HOME_HALF(int id, int isBlack) { return (id & 0X80) != (isBlack << 7); }
+
+// 是否已过河
+inline bool AWAY_HALF(int id, int isBlack) { return (id & 0X80) == (isBlack << 7); }
+
+// 是否在河的同一边 黑方 ID - 51 - 127, 红方 128 - 255  0X80 = 128
+inline bool SAME_HALF(int idSrc, int idDst) {
+    return ((idSrc ^ idDst) & 0X80) == 0;
+}
+
+// 是否在同一行
+inline bool SAME_RANK(int idSrc, int idDst) {
+    return ((idSrc ^ idDst) & 0XF0) == 0;
+}
+
+// 是否在同一列
+inline bool SAME_FILE(int idSrc, int idDst) {
+    return ((idSrc ^ idDst) & 0X0F) == 0;
+}
+
+// 获得红黑标记(红子是8，黑子是16)
+inline int SIDE_TAG(int isBlack) { return 8 + (isBlack << 3); }
+
+// 获得对方红黑标记
+inline int OPP_SIDE_TAG(int isBlack) { return 16 - (isBlack << 3); }
+
+// 获得棋子属于哪一方(红子是0，黑子是1)
+inline int SIDE_INDEX(int type) { return type >> 4; }
+
+// 终点上的棋子是否符合要生成的走法类型：不能是本方棋子，吃子要有对方棋子，不吃子要是空格
+inline bool GEN_WANTED(int typeDst, int sideMask, int nMode) {
+    return (typeDst & sideMask) == 0 && (nMode & (typeDst == 0 ? GEN_QUIET : GEN_CAPTURE)) != 0;
+}
+
+// 获得走法的起点
+inline int SRC(int mv) { return mv & 0XFF; }
+
+// 获得走法的终点
+inline int DST(int mv) { return mv >> 8; }
+
+// 根据起点和终点获得走法
+inline int MOVE(int idSrc, int idDst) { return idSrc + (idDst << 8); }
+
+// 走法水平镜像
+inline int MIRROR_MOVE(int mv) {
+    return MOVE(MIRROR_SQUARE(SRC(mv)), MIRROR_SQUARE(DST(mv)));
+}
+
+// 最低位 1 的位置，n 不能为 0
+inline int LSB(uint64_t n) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, n);
+    return (int)i;
+#else
+    return __builtin_ctzll(n);
+#endif
+}
+
+// 1 的个数
+inline int POPCOUNT(unsigned n) {
+#ifdef _MSC_VER
+    return (int)__popcnt(n);
+#else
+    return __builtin_popcount(n);
+#endif
+}
+
+// 车、炮在一行(列)上的走法，每一位表示线上的一个位置，第 0 位是最左列(最上行)
+typedef struct lineMoves {
+    uint16_t slide;             // 不吃子能走到的空格
+    uint16_t block;             // 两个方向上的第一个棋子，车吃子的目标
+    uint16_t screen;            // 隔一个炮架后的第一个棋子，炮吃子的目标
+} lineMoves;
+
+// 一种长度的线的走法表，下标是棋子在线上的位置和整条线的占位，编译时由 engine.cpp 的 makeLineTable 生成
+template <int N>
+struct lineTable {
+    lineMoves moves[N][1 << N];
+    constexpr const lineMoves* operator[](int p) const { return moves[p]; }
+};
+
+extern const lineTable<9> rankMoves;       // 按行查：列号 - FILE_LEFT，行的占位 rankOcc
+extern const lineTable<10> fileMoves;      // 按列查：行号 - RANK_TOP，列的占位 fileOcc
+
+#ifdef USE_BITBOARD
+#include "bitboard.h"
+#endif
+
+#ifdef USE_NNUE
+#define NNUE_HIDDEN     128                 // 神经网络评价每个视角的累加器宽度，见 nnue.h
+
+// 神经网络评价的累加器，addPiece、delPiece 增量更新
+typedef struct nnueAccumulator {
+    int16_t vls[2][NNUE_HIDDEN];   // 红方、黑方视角的累加器
+    bool bDirty[2];                // 该视角的帅(将)动过，评价前要重算
+} nnueAccumulator;
+#endif
+
+// Zobrist 键值表
+typedef struct zobristStruct {
+    uint64_t player;            // 走子方键值，轮到黑方走时异或进去
+    uint64_t table[14][256];    // 棋子键值，0-6 红方，7-13 黑方
+} zobristStruct;
+
+extern zobristStruct Zobrist;
+
+// 棋子在 Zobrist 表中的序号
+inline int ZOBRIST_INDEX(int type) { return type < 16 ? type - 8 : type - 16 + 7; }
+
+// 重复局面的结果，相对走子方，见 repStatus
+#define REP_NONE        0
+#define REP_DRAW        1   // 双方都没有长将、长捉，或者都有
+#define REP_LOSS        2   // 走子方长将或长捉，判负
+#define REP_WIN         3   // 对方长将或长捉
+
+// 历史走法栈的一项，走一步棋压入一项
+typedef struct moveStackItem {
+    uint64_t zobrist;           // 走这步棋之前的 Zobrist 键值
+    int mv;                     // 走法，0 表示空着或者历史的起点
+    char pcCaptured;            // 被吃的棋子，0 表示没有吃子
+    bool bCheck;                // 走完以后是否将军
+} moveStackItem;
+
+// 局面结构
+typedef struct positionStruct {
+    bool blackPlayer;           // 轮到谁走，0=红方，1=黑方
+    int  vlRed, vlBlack;        // 红、黑双方的子力价值
+    int  nDistance;             // 距离根节点的步数
+    uint64_t zobrist;           // Zobrist 键值，随走子增量更新
+    char curboard[256];         // 棋盘上的棋子
+    unsigned char pieceList[2][16];  // 双方棋子所在的格子，0=红方，1=黑方
+    unsigned char pieceIndex[256];   // 格子上的棋子在"pieceList"中的序号
+    int  nPieces[2];            // 双方的棋子数
+    int  kingSquare[2];         // 双方帅(将)所在的格子，0 表示不在棋盘上
+    int  nMoveNum;              // 历史走法栈中的项数，第 0 项是起点
+    moveStackItem moveStack[MAX_MOVE_NUM];  // 历史走法栈，查重复局面用
+    uint16_t rankOcc[16];       // 每行的占位，下标是行，第 i 位是第 FILE_LEFT + i 列
+    uint16_t fileOcc[16];       // 每列的占位，下标是列，第 i 位是第 RANK_TOP + i 行
+#ifdef USE_BITBOARD
+    bitboard occSide[2];        // 双方棋子的位棋盘
+#endif
+#ifdef USE_NNUE
+    nnueAccumulator acc;        // 神经网络评价的累加器
+#endif
+} positionStruct;
+
+extern positionStruct pos;  // 局面实例
+
+// 车、炮在一条线上的走法，nBase 是线上第 0 个位置的格子，nStep 是相邻位置的步长
+inline int lineMovesGen(positionStruct* pos, const lineMoves* lm, bool bCannon, int idSrc,
+                        int nBase, int nStep, int pcOppSide, int nMode, int* mvs) {
+    int n = 0, idDst;
+    unsigned bits;
+    // 1. 不吃子的走法
+    for (bits = (nMode & GEN_QUIET) != 0 ? lm->slide : 0; bits != 0; bits &= bits - 1) {
+        mvs[n++] = MOVE(idSrc, nBase + LSB(bits) * nStep);
+    }
+    // 2. 吃子的走法，车吃第一个棋子，炮吃炮架后的第一个棋子
+    bits = (nMode & GEN_CAPTURE) == 0 ? 0 : bCannon ? lm->screen : lm->block;
+    for (; bits != 0; bits &= bits - 1) {
+        idDst = nBase + LSB(bits) * nStep;
+        if ((pos->curboard[idDst] & pcOppSide) != 0) {
+            mvs[n++] = MOVE(idSrc, idDst);
+        }
+    }
+    return n;
+}
+
+// 与搜索有关的全局变量
+typedef struct searchStruct searchStruct;
+
+#ifdef SEARCH_STATS
+#include <stdio.h>
+// 搜索效率的统计，编译时定义 SEARCH_STATS 才有。每个线程一份，只有本线程写，
+// 主线程每完成一次迭代，在 searchMain 里写一行 JSON，见 setoption statsfile
+typedef struct statStruct {
+    int64_t nNodes;            // 节点数，和 threadStruct 的 nNodes 相同，复制过来方便算差值
+    int64_t nQNodes;           // 静态搜索的节点数
+    int64_t nHashProbes;       // 完全搜索查置换表的次数
+    int64_t nHashHits;         // 查到的项能截断或者给出了走法
+    int64_t nBetaCuts;         // 完全搜索的 Beta 截断次数
+    int64_t nFirstCuts;        // 其中第一个走法就截断的次数
+} statStruct;
+
+#define STAT_ADD(thd, field, n) ((thd)->stats.field += (n))
+#else
+#define STAT_ADD(thd, field, n)
+#endif
+
+// 一个搜索线程的数据，每个线程在自己的局面副本上搜索，只共用置换表
+typedef struct threadStruct {
+    positionStruct pos;        // 线程自己的局面，搜索开始时从要搜索的局面复制
+    searchStruct* lpSearch;    // 线程所属的搜索，限制、选项和停止标志都在里面
+    int nThread;               // 线程编号，0 是主线程，其余是辅助线程
+    int mvResult;              // 根节点最后找到的最佳走法
+    bool bRepValue;            // 刚返回的分值受到重复局面的影响，与路径有关，见 searchFull
+    int64_t nNodes;            // 本线程搜索的节点数
+    int64_t nLmrReduced;       // 减少深度搜索的走法数
+    int64_t nLmrPlies;         // 一共减少的深度
+    int64_t nLmrResearched;    // 减少深度后超过 Alpha、按原深度重新搜索的走法数
+    int nHistoryTable[65536];  // 历史表
+    int mvKillers[LIMIT_DEPTH][2];  // 杀手走法表，按距离根节点的步数保存两个
+#ifdef SEARCH_STATS
+    statStruct stats;          // 本线程这次搜索的统计
+#endif
+} threadStruct;
+
+typedef struct searchStruct {
+    int mvResult;              // 电脑走的棋
+    int mvPonder;              // 预测的对方应着，即主要变例的第二步，从置换表取得，0 表示没有
+    int vlResult;              // 最后完成的一次迭代的分值
+    int nDepthResult;          // 最后完成的迭代深度
+    int nMaxDepth;             // 最大搜索深度，0 表示 LIMIT_DEPTH
+    int nMaxTime;              // 每步的思考时间(毫秒)，0 表示不限
+    int nClockTime;            // 棋钟剩余时间(毫秒)，0 表示不用棋钟，nMaxTime 不为 0 时不用
+    int nIncrement;            // 棋钟每步的加秒(毫秒)
+    int nMovesToGo;            // 到下一次加时还要走的步数，0 表示不知道
+    int64_t nMaxNodes;         // 主线程最多搜索的节点数，0 表示不限
+    std::atomic<int64_t> tStart;  // 开始搜索的时间(毫秒)，见 searchClock，后台思考命中时改成命中的时间
+    int nSoftTime;             // 超过这个时间(毫秒)就不开始新一次迭代，0 表示不限
+    int nHardTime;             // 超过这个时间(毫秒)就中止搜索，0 表示不限
+    int64_t nNodes;            // 所有线程搜索的节点数，搜索结束后统计
+    int mvDepth[LIMIT_DEPTH + 1];          // 每次完成的迭代给出的走法，下标是深度
+    int nDepthTime[LIMIT_DEPTH + 1];       // 完成这次迭代时的用时(毫秒)
+    int64_t nDepthNodes[LIMIT_DEPTH + 1];  // 完成这次迭代时主线程的节点数
+    int64_t nLmrReduced, nLmrPlies, nLmrResearched;  // 所有线程后期走法减少深度的统计
+    int nThreads;              // 搜索线程数，包括主线程
+    threadStruct* threads;     // 每个线程的数据，由 threadsInit 分配
+    bool bPvs;                 // 使用主要变例搜索(零窗口搜索非首个走法)
+    bool bAspiration;          // 迭代加深时使用期望窗口
+    bool bNullMove;            // 使用空着裁剪
+    bool bNullVerify;          // 空着裁剪截断前做验证搜索
+    bool bLmr;                 // 使用后期走法减少深度
+    int vlLazyMargin1;         // 局面评价只算子力位置价值后，离窗口超过这个余量就不再算后面几层
+    int vlLazyMargin2;         // 算完帅(将)的安全和兵(卒)的连接后，离窗口超过这个余量就不再算灵活性
+    std::atomic<bool> bStop;   // 要求停止搜索，可以由其他线程设置
+    std::atomic<bool> bHelperStop;  // 主线程搜索完毕，通知辅助线程停止
+    std::atomic<bool> bTimeout;     // 主线程发现超时，中止搜索
+    std::atomic<bool> bPonder;      // 后台思考：不计时，搜索完也要等到命中(ponderHit)或者停止才结束
+    bool bInfinite;            // 无限思考：搜索完(找到杀棋或者到了极限深度)也要等到停止才结束
+    bool bWarmHistory;         // 上一次是没有命中的后台思考，这次搜索保留一部分历史表
+#ifdef SEARCH_STATS
+    FILE* fpStats;             // 写 JSON 统计的文件，NULL 表示不写
+    statStruct statLast;       // 上一次迭代完成时主线程的统计
+    int64_t nIterNodes;        // 上一次迭代主线程搜索的节点数，算有效分支因子用
+#endif
+} searchStruct;
+
+// 走子方帅(将)受到的牵制，每个节点算一次，判断走法会不会送将时大多不用试走，见 initPins
+typedef struct pinStruct {
+    bool bInCheck;              // 是否被将军，被将军时只试走可能应将的走法
+    int idKing;                 // 帅(将)所在的格子，帅(将)的走法总是试走
+    int nRayMask;               // 第 i 位表示 kingDelta[i] 方向上最近的三个棋子中有对方的车、炮、帅(将)，
+                                // 起点或终点在这些方向上的走法要试走
+    int nPins;                  // 做马腿挡住对方马的棋子数
+    int idPinned[4];            // 做马腿的棋子
+    int idLimit[4];             // 只能吃这个格子上的马，挡住两个马时是 0
+} pinStruct;
+
+// 走法排序结构，按阶段逐步生成走法，每次只挑出一个最好的
+typedef struct moveSortStruct {
+    int mvHash, mvKiller1, mvKiller2;  // 置换表走法和两个杀手走法
+    int nPhase, nIndex, nGenMoves;     // 当前阶段，下一个走法的序号，走法数
+    int mvs[MAX_GEN_MOVES];            // 当前阶段生成的走法
+    int vls[MAX_GEN_MOVES];            // 走法的排序分值
+    pinStruct pins;                    // 只返回不送将的走法
+} moveSortStruct;
+
+extern searchStruct Search;
+
+void initZobrist(void);
+void initEngine(void);
+bool hashInit(int nMB);
+void hashClear(void);
+bool threadsInit(int nThreads, searchStruct* lpSearch = &Search);
+int64_t searchClock(void);
+
+void clearBoard(positionStruct* pos);
+void changeSide(positionStruct* pos);
+void addPiece(positionStruct* pos, int id, int type);
+void delPiece(positionStruct* pos, int id, int type);
+int evaluate(positionStruct* pos, int vlAlpha = -MATE_VALUE, int vlBeta = MATE_VALUE,
+             const searchStruct* lpSearch = &Search);
+int movePiece(positionStruct* pos, int mv);
+void undoMovePiece(positionStruct* pos, int mv, int typeDst);
+bool makeMove(positionStruct* pos, int mv, int* typeDst);
+void makeLegalMove(positionStruct* pos, int mv, int* typeDst);
+void undoMakeMove(positionStruct* pos, int mv, int pcCaptured);
+void makeNullMove(positionStruct* pos);
+void undoMakeNullMove(positionStruct* pos);
+bool nullOkay(positionStruct* pos);
+void setIrreversible(positionStruct* pos);
+int repStatus(positionStruct* pos);
+int repValue(positionStruct* pos, int nStatus);
+bool checked(positionStruct* pos);
+int generateMoves(positionStruct* pos, int* mvs, int nMode = GEN_ALL);
+bool legalMove(positionStruct* pos, int mv);
+void initPins(positionStruct* pos, pinStruct* pins);
+bool safeMove(positionStruct* pos, const pinStruct* pins, int mv);
+int generateLegalMoves(positionStruct* pos, const pinStruct* pins, int* mvs, int nMode = GEN_ALL);
+bool hasLegalMove(positionStruct* pos);
+void startup(positionStruct* pos);
+
+// FEN 串和 ICCS 坐标格式走法(如 "h2e2")的转换
+bool fromFen(positionStruct* pos, const char* szFen);
+int strToMove(const char* str);
+void moveToStr(int mv, char* str);
+
+void initSort(threadStruct* thd, moveSortStruct* sort, int mvHash);
+int nextMove(threadStruct* thd, moveSortStruct* sort);
+
+int searchQuiesce(threadStruct* thd, int vlAlpha, int vlBeta);
+int searchFull(threadStruct* thd, int vlAlpha, int vlBeta, int nDepth, bool bNoNull = false);
+void searchMain(searchStruct* lpSearch = &Search, positionStruct* lpPos = &pos);
+
+// 后台思考命中：从现在开始按 lpSearch 的限制计时，搜索继续进行
+void ponderHit(searchStruct* lpSearch = &Search);
+// 后台思考时等到命中或者停止，无限思考时等到停止
+void ponderWait(searchStruct* lpSearch = &Search);
+
+#endif
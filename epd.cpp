@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include "epd.h"
+
+// 一道测试题
+typedef struct epdStruct {
+    char szFen[128];                // 棋盘和走子方
+    char szId[64];                  // 题目名，没有时为空
+    int nBest, nAvoid;
+    int mvBest[EPD_MAX_MOVES];      // 正解
+    int mvAvoid[EPD_MAX_MOVES];     // 要避免的走法
+} epdStruct;
+
+// 读入 ';' 之前的走法，返回走法数，格式不对返回 -1
+int epdMoves(const char* p, int* mvs) {
+    int n = 0;
+    for (;;) {
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == ';' || *p == '\0' || *p == '\r' || *p == '\n') {
+            return n;
+        }
+        if (n == EPD_MAX_MOVES) {
+            return -1;
+        }
+        mvs[n] = strToMove(p);
+        if (mvs[n] == 0 || (p[4] != ' ' && p[4] != '\t' && p[4] != ';' && p[4] != '\0' && p[4] != '\r' &&
+                            p[4] != '\n')) {
+            return -1;
+        }
+        n++;
+        p += 4;
+    }
+}
+
+// 解析一行，空行、注释和没有 bm、am 的行返回 false；走法格式不对时 nBest 为 -1
+bool epdParse(const char* szLine, epdStruct* epd) {
+    const char* p = szLine;
+    const char* q;
+    size_t n;
+    int nMoves;
+
+    epd->szId[0] = '\0';
+    epd->nBest = epd->nAvoid = 0;
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if (*p == '#' || *p == '\0' || *p == '\r' || *p == '\n') {
+        return false;
+    }
+
+    // 1. 棋盘和走子方两个字段
+    q = p + strcspn(p, " \t\r\n");
+    q += strspn(q, " \t");
+    q += strcspn(q, " \t\r\n;");
+    n = (size_t)(q - p) < sizeof(epd->szFen) - 1 ? (size_t)(q - p) : sizeof(epd->szFen) - 1;
+    memcpy(epd->szFen, p, n);
+    epd->szFen[n] = '\0';
+
+    // 2. 跳过 "-" 和数字字段，后面是用 ';' 隔开的操作
+    p = q;
+    for (;;) {
+        p += strspn(p, " \t");
+        if (*p != '-' && (*p < '0' || *p > '9')) {
+            break;
+        }
+        p += strcspn(p, " \t\r\n;");
+    }
+    while (*p != '\0' && *p != '\r' && *p != '\n') {
+        p += strspn(p, " \t;");
+        if (strncmp(p, "bm ", 3) == 0 || strncmp(p, "am ", 3) == 0) {
+            nMoves = epdMoves(p + 3, p[0] == 'b' ? epd->mvBest : epd->mvAvoid);
+            if (nMoves < 0) {
+                epd->nBest = -1;
+                return true;
+            }
+            *(p[0] == 'b' ? &epd->nBest : &epd->nAvoid) = nMoves;
+        }
+        else if (strncmp(p, "id ", 3) == 0) {
+            q = strchr(p, '"');
+            if (q != NULL) {
+                n = strcspn(q + 1, "\"\r\n");
+                n = n < sizeof(epd->szId) - 1 ? n : sizeof(epd->szId) - 1;
+                memcpy(epd->szId, q + 1, n);
+                epd->szId[n] = '\0';
+                p = q + 1 + strcspn(q + 1, "\"\r\n");
+                p += *p == '"' ? 1 : 0;
+            }
+        }
+        // 下一个操作
+        p += strcspn(p, ";\r\n");
+    }
+    return epd->nBest > 0 || epd->nAvoid > 0;
+}
+
+// 走法是正解，并且不是要避免的走法
+bool epdGood(const epdStruct* epd, int mv) {
+    int i;
+    bool bGood = epd->nBest == 0;
+    for (i = 0; i < epd->nBest; i++) {
+        bGood = bGood || epd->mvBest[i] == mv;
+    }
+    for (i = 0; i < epd->nAvoid; i++) {
+        bGood = bGood && epd->mvAvoid[i] != mv;
+    }
+    return mv != 0 && bGood;
+}
+
+int compareInt64(const void* p1, const void* p2) {
+    int64_t n1 = *(const int64_t*)p1, n2 = *(const int64_t*)p2;
+    return n1 < n2 ? -1 : n1 > n2 ? 1 : 0;
+}
+
+// 中位数，会把数组排序
+int64_t median(int64_t* lpValues, int n) {
+    if (n == 0) {
+        return 0;
+    }
+    qsort(lpValues, (size_t)n, sizeof(int64_t), compareInt64);
+    return n % 2 == 1 ? lpValues[n / 2] : (lpValues[n / 2 - 1] + lpValues[n / 2]) / 2;
+}
+
+bool epdSuite(const char* szFile, int nTime, int64_t nNodes) {
+    char szLine[1024];
+    char szMove[5];
+    epdStruct epd;
+    int i, d, nLine, nPositions, nSolved, nMaxSolved;
+    int64_t tTotal, nNodesTotal;
+    int64_t* tSolved;
+    int64_t* nNodesSolved;
+    int64_t* lpNew;
+    bool bOk;
+    FILE* fp;
+    positionStruct posSaved = pos;  // 测试完恢复原来的局面
+
+    fp = fopen(szFile, "r");
+    if (fp == NULL) {
+        printf("cannot open %s\n", szFile);
+        return false;
+    }
+    Search.nMaxDepth = 0;
+    Search.nMaxTime = nTime;
+    Search.nClockTime = 0;
+    Search.nMaxNodes = nNodes;
+    nLine = nPositions = nSolved = 0;
+    nMaxSolved = 256;
+    tSolved = (int64_t*)malloc(nMaxSolved * sizeof(int64_t));
+    nNodesSolved = (int64_t*)malloc(nMaxSolved * sizeof(int64_t));
+    while (tSolved != NULL && nNodesSolved != NULL && fgets(szLine, sizeof(szLine), fp) != NULL) {
+        nLine++;
+        if (!epdParse(szLine, &epd)) {
+            continue;
+        }
+        // 1. 检查局面和走法
+        bOk = epd.nBest >= 0 && fromFen(&pos, epd.szFen);
+        for (i = 0; bOk && i < epd.nBest; i++) {
+            bOk = legalMove(&pos, epd.mvBest[i]);
+        }
+        for (i = 0; bOk && i < epd.nAvoid; i++) {
+            bOk = legalMove(&pos, epd.mvAvoid[i]);
+        }
+        if (!bOk) {
+            printf("line %d error %s", nLine, szLine);
+            continue;
+        }
+
+        // 2. 搜索，每题从空的置换表开始
+        hashClear();
+        Search.bStop = false;
+        searchMain();
+        nPositions++;
+
+        // 3. 从最后完成的迭代往前找，一直给出正解的最浅的一次迭代
+        d = Search.nDepthResult;
+        while (d > 0 && epdGood(&epd, Search.mvDepth[d])) {
+            d--;
+        }
+        moveToStr(Search.mvResult, szMove);
+        if (d == Search.nDepthResult) {
+            printf("line %d id \"%s\" failed depth %d bestmove %s\n", nLine, epd.szId, Search.nDepthResult,
+                   szMove);
+            fflush(stdout);
+            continue;
+        }
+        d++;
+        if (nSolved == nMaxSolved) {
+            nMaxSolved *= 2;
+            lpNew = (int64_t*)realloc(tSolved, nMaxSolved * sizeof(int64_t));
+            if (lpNew == NULL) {
+                break;
+            }
+            tSolved = lpNew;
+            lpNew = (int64_t*)realloc(nNodesSolved, nMaxSolved * sizeof(int64_t));
+            if (lpNew == NULL) {
+                break;
+            }
+            nNodesSolved = lpNew;
+        }
+        tSolved[nSolved] = Search.nDepthTime[d];
+        nNodesSolved[nSolved] = Search.nDepthNodes[d];
+        nSolved++;
+        printf("line %d id \"%s\" solved depth %d time %d nodes %lld bestmove %s\n", nLine, epd.szId, d,
+               Search.nDepthTime[d], (long long)Search.nDepthNodes[d], szMove);
+        fflush(stdout);
+    }
+    fclose(fp);
+
+    // 4. 汇总，只统计解出的题目
+    tTotal = nNodesTotal = 0;
+    for (i = 0; i < nSolved; i++) {
+        tTotal += tSolved[i];
+        nNodesTotal += nNodesSolved[i];
+    }
+    printf("solved %d/%d time mean %lld median %lld nodes mean %lld median %lld\n", nSolved, nPositions,
+           (long long)(nSolved > 0 ? tTotal / nSolved : 0), (long long)median(tSolved, nSolved),
+           (long long)(nSolved > 0 ? nNodesTotal / nSolved : 0), (long long)median(nNodesSolved, nSolved));
+    fflush(stdout);
+    free(tSolved);
+    free(nNodesSolved);
+    pos = posSaved;
+    return true;
+}
@@ -0,0 +1,22 @@
+#ifndef LVENW_EPD_H
+#define LVENW_EPD_H
+
+// EPD 测试题：逐题搜索，统计找到正解的深度、用时和节点数，比较改动前后找战术的快慢。
+//
+// 每行一题，先是 FEN 串的棋盘和走子方，后面可以有 "- - 0 1" 之类的字段，然后是用 ';' 隔开的操作：
+// "bm <走法> ..." 是正解(任何一个都算对)，"am <走法> ..." 是要避免的走法，"id "<名字>"" 是题目名，
+// 其他操作忽略。走法用 ICCS 坐标格式(如 "h2e2")，bm、am 都没有的行和 '#' 开头的行跳过。
+//
+// 每题从空的置换表开始，在时间和节点数的限制内迭代加深。从某次迭代开始，之后每次迭代给出的
+// 走法都是正解(不是要避免的走法)，就算解出，这次迭代的深度、用时和节点数就是解题的深度、用时和节点数。
+// 最后输出解出的题数，以及解出的题目用时、节点数的平均值和中位数。
+
+#include "engine.h"
+
+#define EPD_TIME        1000                // 默认每题的时间(毫秒)
+#define EPD_MAX_MOVES   16                  // 每题最多的 bm、am 走法数
+
+// nTime 是每题的时间(毫秒)，nNodes 是每题的节点数，0 表示不限；文件打不开返回 false
+bool epdSuite(const char* szFile, int nTime, int64_t nNodes);
+
+#endif
@@ -0,0 +1,77 @@
+#include "mapfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool mapFileOpen(mappedFile* mf, const char* szFile) {
+    mf->lpData = NULL;
+    mf->nSize = 0;
+#ifdef _WIN32
+    LARGE_INTEGER liSize;
+    mf->hMap = NULL;
+    mf->hFile = CreateFileA(szFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mf->hFile == INVALID_HANDLE_VALUE) {
+        mf->hFile = NULL;
+        return false;
+    }
+    if (!GetFileSizeEx(mf->hFile, &liSize) || liSize.QuadPart == 0) {
+        mapFileClose(mf);
+        return false;
+    }
+    mf->nSize = (size_t)liSize.QuadPart;
+    mf->hMap = CreateFileMappingA(mf->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mf->hMap == NULL) {
+        mapFileClose(mf);
+        return false;
+    }
+    mf->lpData = MapViewOfFile(mf->hMap, FILE_MAP_READ, 0, 0, 0);
+#else
+    struct stat st;
+    void* lp;
+    int fd = open(szFile, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    mf->nSize = (size_t)st.st_size;
+    lp = mmap(NULL, mf->nSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // 映射建立后就可以关闭文件
+    mf->lpData = lp == MAP_FAILED ? NULL : lp;
+#endif
+    if (mf->lpData == NULL) {
+        mapFileClose(mf);
+        return false;
+    }
+    return true;
+}
+
+void mapFileClose(mappedFile* mf) {
+#ifdef _WIN32
+    if (mf->lpData != NULL) {
+        UnmapViewOfFile(mf->lpData);
+    }
+    if (mf->hMap != NULL) {
+        CloseHandle(mf->hMap);
+    }
+    if (mf->hFile != NULL) {
+        CloseHandle(mf->hFile);
+    }
+    mf->hMap = mf->hFile = NULL;
+#else
+    if (mf->lpData != NULL) {
+        munmap((void*)mf->lpData, mf->nSize);
+    }
+#endif
+    mf->lpData = NULL;
+    mf->nSize = 0;
+}
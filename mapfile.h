@@ -0,0 +1,21 @@
+#ifndef LVENW_MAPFILE_H
+#define LVENW_MAPFILE_H
+
+// 只读的内存映射文件，Windows 用 CreateFileMapping，其他平台用 mmap
+
+#include <stddef.h>
+
+typedef struct mappedFile {
+    const void* lpData;         // 文件内容，没有打开时是 NULL
+    size_t nSize;               // 文件大小(字节)
+#ifdef _WIN32
+    void* hFile;                // 文件和映射对象的句柄(HANDLE)
+    void* hMap;
+#endif
+} mappedFile;
+
+// 映射整个文件，空文件或失败返回 false；mf 必须是关闭的(清零或 mapFileClose 过)
+bool mapFileOpen(mappedFile* mf, const char* szFile);
+void mapFileClose(mappedFile* mf);
+
+#endif
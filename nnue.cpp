@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include "nnue.h"
+
+#ifdef USE_NNUE
+
+#define NNUE_MAX_VALUE  3000                // 网络评价的范围，远低于长将判负和杀棋的分值
+
+nnueStruct Nnue;
+
+// 截断到 [0, 127]
+inline int CLIPPED(int n) {
+    return n < 0 ? 0 : n > 127 ? 127 : n;
+}
+
+// 把累加器截断到 [0, 127] 写到 lpInputs
+inline void NNUE_CLIP(int16_t* lpInputs, const int16_t* lpAcc) {
+    int i;
+#if defined(NNUE_AVX2)
+    __m256i lo = _mm256_setzero_si256(), hi = _mm256_set1_epi16(127);
+    for (i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(lpAcc + i));
+        _mm256_storeu_si256((__m256i*)(lpInputs + i), _mm256_min_epi16(_mm256_max_epi16(a, lo), hi));
+    }
+#elif defined(NNUE_SSE2)
+    __m128i lo = _mm_setzero_si128(), hi = _mm_set1_epi16(127);
+    for (i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(lpAcc + i));
+        _mm_storeu_si128((__m128i*)(lpInputs + i), _mm_min_epi16(_mm_max_epi16(a, lo), hi));
+    }
+#else
+    for (i = 0; i < NNUE_HIDDEN; i++) {
+        lpInputs[i] = (int16_t)CLIPPED(lpAcc[i]);
+    }
+#endif
+}
+
+// 两个 int16 向量的点积，n 是 16 的倍数
+inline int32_t NNUE_DOT(const int16_t* a, const int16_t* b, int n) {
+    int i;
+#if defined(NNUE_AVX2)
+    __m256i s = _mm256_setzero_si256();
+    __m128i t;
+    for (i = 0; i < n; i += 16) {
+        s = _mm256_add_epi32(s, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                                  _mm256_loadu_si256((const __m256i*)(b + i))));
+    }
+    t = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0X4E));
+    t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0XB1));
+    return _mm_cvtsi128_si32(t);
+#elif defined(NNUE_SSE2)
+    __m128i s = _mm_setzero_si128();
+    for (i = 0; i < n; i += 8) {
+        s = _mm_add_epi32(s, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(a + i)),
+                                            _mm_loadu_si128((const __m128i*)(b + i))));
+    }
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0X4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0XB1));
+    return _mm_cvtsi128_si32(s);
+#else
+    int32_t s = 0;
+    for (i = 0; i < n; i++) {
+        s += a[i] * b[i];
+    }
+    return s;
+#endif
+}
+
+const char* nnueSimd(void) {
+#if defined(NNUE_AVX2)
+    return "avx2";
+#elif defined(NNUE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void nnueClose(void) {
+    free(Nnue.lpWeights);
+    Nnue.lpWeights = NULL;
+    Nnue.bLoaded = false;
+}
+
+// 读入 n 个 int8 扩展成 int16
+bool readInt8(FILE* fp, int16_t* lpDst, int n) {
+    int8_t buf[2 * NNUE_HIDDEN];
+    int i;
+    if (n > (int)sizeof(buf) || fread(buf, 1, n, fp) != (size_t)n) {
+        return false;
+    }
+    for (i = 0; i < n; i++) {
+        lpDst[i] = buf[i];
+    }
+    return true;
+}
+
+bool nnueLoad(const char* szFile) {
+    FILE* fp;
+    char szMagic[4];
+    uint32_t nDims[3];
+    int j;
+    bool bOk;
+
+    nnueClose();
+    fp = fopen(szFile, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+    // 1. 文件头，网络的大小要和编译时的一样
+    bOk = fread(szMagic, 1, 4, fp) == 4 && memcmp(szMagic, "LVNN", 4) == 0 &&
+          fread(nDims, sizeof(uint32_t), 3, fp) == 3 && nDims[0] == NNUE_INPUTS &&
+          nDims[1] == NNUE_HIDDEN && nDims[2] == NNUE_L2;
+    // 2. 累加器的偏置和特征权重
+    if (bOk) {
+        Nnue.lpWeights = (int16_t*)malloc((size_t)NNUE_INPUTS * NNUE_HIDDEN * sizeof(int16_t));
+        bOk = Nnue.lpWeights != NULL &&
+              fread(Nnue.biases, sizeof(int16_t), NNUE_HIDDEN, fp) == NNUE_HIDDEN &&
+              fread(Nnue.lpWeights, sizeof(int16_t), (size_t)NNUE_INPUTS * NNUE_HIDDEN, fp) ==
+              (size_t)NNUE_INPUTS * NNUE_HIDDEN;
+    }
+    // 3. 后面的小网络
+    for (j = 0; bOk && j < NNUE_L2; j++) {
+        bOk = readInt8(fp, Nnue.l2Weights[j], 2 * NNUE_HIDDEN);
+    }
+    bOk = bOk && fread(Nnue.l2Biases, sizeof(int32_t), NNUE_L2, fp) == NNUE_L2 &&
+          readInt8(fp, Nnue.outWeights, NNUE_L2) && fread(&Nnue.outBias, sizeof(int32_t), 1, fp) == 1;
+    fclose(fp);
+    if (!bOk) {
+        nnueClose();
+        return false;
+    }
+    Nnue.bLoaded = true;
+    pos.acc.bDirty[0] = pos.acc.bDirty[1] = true;
+    return true;
+}
+
+void nnueRandom(void) {
+    uint64_t nSeed = 1;
+    int i, j;
+
+    // 取随机数的高位，范围是 [-n, n)
+#define NNUE_RANDOM(n) (nSeed = nSeed * 6364136223846793005ULL + 1442695040888963407ULL, \
+                        (int)((nSeed >> 40) % (2 * (n))) - (n))
+    nnueClose();
+    Nnue.lpWeights = (int16_t*)malloc((size_t)NNUE_INPUTS * NNUE_HIDDEN * sizeof(int16_t));
+    if (Nnue.lpWeights == NULL) {
+        return;
+    }
+    for (i = 0; i < NNUE_HIDDEN; i++) {
+        Nnue.biases[i] = (int16_t)(48 + NNUE_RANDOM(16));
+    }
+    for (i = 0; i < NNUE_INPUTS * NNUE_HIDDEN; i++) {
+        Nnue.lpWeights[i] = (int16_t)NNUE_RANDOM(8);
+    }
+    for (j = 0; j < NNUE_L2; j++) {
+        for (i = 0; i < 2 * NNUE_HIDDEN; i++) {
+            Nnue.l2Weights[j][i] = (int16_t)NNUE_RANDOM(16);
+        }
+        Nnue.l2Biases[j] = NNUE_RANDOM(1024);
+        Nnue.outWeights[j] = (int16_t)NNUE_RANDOM(64);
+    }
+    Nnue.outBias = 0;
+#undef NNUE_RANDOM
+    Nnue.bLoaded = true;
+    pos.acc.bDirty[0] = pos.acc.bDirty[1] = true;
+}
+
+void nnueRefresh(positionStruct* pos, int side) {
+    int i, k, id, idKing;
+    int16_t* lpAcc = pos->acc.vls[side];
+
+    memcpy(lpAcc, Nnue.biases, sizeof(Nnue.biases));
+    idKing = pos->kingSquare[side];
+    if (idKing != 0) {
+        // 双方的棋子都是特征，只有本方的帅(将)不是
+        for (k = 0; k < 2; k++) {
+            for (i = 0; i < pos->nPieces[k]; i++) {
+                id = pos->pieceList[k][i];
+                if (id != idKing) {
+                    NNUE_UPDATE(lpAcc, Nnue.lpWeights +
+                                NNUE_FEATURE(side, idKing, id, pos->curboard[id]) * NNUE_HIDDEN, 1);
+                }
+            }
+        }
+    }
+    pos->acc.bDirty[side] = false;
+}
+
+int nnueEvaluate(positionStruct* pos) {
+    int j, vl, side = pos->blackPlayer;
+    int32_t nSum;
+    int16_t inputs[2 * NNUE_HIDDEN];
+    int16_t hidden[NNUE_L2];
+
+    // 1. 帅(将)动过的视角重算
+    if (pos->acc.bDirty[0]) {
+        nnueRefresh(pos, 0);
+    }
+    if (pos->acc.bDirty[1]) {
+        nnueRefresh(pos, 1);
+    }
+
+    // 2. 走子方的累加器在前，截断后作为输入
+    NNUE_CLIP(inputs, pos->acc.vls[side]);
+    NNUE_CLIP(inputs + NNUE_HIDDEN, pos->acc.vls[1 - side]);
+
+    // 3. 第二层
+    for (j = 0; j < NNUE_L2; j++) {
+        nSum = Nnue.l2Biases[j] + NNUE_DOT(inputs, Nnue.l2Weights[j], 2 * NNUE_HIDDEN);
+        hidden[j] = (int16_t)CLIPPED(nSum >> NNUE_L2_SHIFT);
+    }
+
+    // 4. 输出
+    nSum = Nnue.outBias + NNUE_DOT(hidden, Nnue.outWeights, NNUE_L2);
+    vl = nSum >> NNUE_OUT_SHIFT;
+    return vl < -NNUE_MAX_VALUE ? -NNUE_MAX_VALUE : vl > NNUE_MAX_VALUE ? NNUE_MAX_VALUE : vl;
+}
+
+#endif
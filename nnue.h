@@ -0,0 +1,125 @@
+#ifndef LVENW_NNUE_H
+#define LVENW_NNUE_H
+
+// 可增量更新的神经网络评价：编译时定义 USE_NNUE 启用，启动时从文件读入权重，
+// 读入成功后 evaluate 改用网络的输出，没有权重文件时仍用原来的评价。
+//
+// 输入特征是 (本方帅(将)在九宫中的位置, 棋子, 格子)，黑方的视角把棋盘旋转 180 度，
+// 棋子分本方、对方各 7 种(本方的帅(将)不算)，一共 9 * 14 * 90 个。
+// 每一方的视角有一个 NNUE_HIDDEN 个 int16 的累加器，等于偏置加上所有特征的权重，
+// addPiece、delPiece 只加减一行权重；本方帅(将)走动后整个视角重算。
+// 后面是一个小的量化网络：
+// 1. 走子方、对方的累加器截断到 [0, 127]，拼成 2 * NNUE_HIDDEN 个输入；
+// 2. NNUE_L2 个神经元，int8 权重，int32 偏置，结果右移 NNUE_L2_SHIFT 位后截断到 [0, 127]；
+// 3. 一个输出，int8 权重，int32 偏置，结果右移 NNUE_OUT_SHIFT 位就是相对走子方的分值。
+//
+// 权重文件按小端保存，依次是：
+// "LVNN"，uint32 的 NNUE_INPUTS、NNUE_HIDDEN、NNUE_L2，
+// int16 累加器偏置[NNUE_HIDDEN]，int16 特征权重[NNUE_INPUTS][NNUE_HIDDEN]，
+// int8 第二层权重[NNUE_L2][2 * NNUE_HIDDEN]，int32 第二层偏置[NNUE_L2]，
+// int8 输出权重[NNUE_L2]，int32 输出偏置。
+
+#include "engine.h"
+
+#ifdef USE_NNUE
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NNUE_AVX2
+#elif (defined(__SSE2__) && defined(__x86_64__)) || defined(_M_X64)
+#include <emmintrin.h>
+#define NNUE_SSE2
+#endif
+
+#define NNUE_FILE       "lvenw.nnue"        // 默认的权重文件
+#define NNUE_INPUTS     (9 * 14 * 90)       // 输入特征数
+#define NNUE_L2         32                  // 第二层的神经元数
+#define NNUE_L2_SHIFT   6
+#define NNUE_OUT_SHIFT  4
+
+typedef struct nnueStruct {
+    bool bLoaded;                           // 读入了权重，evaluate 使用网络
+    int16_t* lpWeights;                     // 特征权重，NNUE_INPUTS 行，每行 NNUE_HIDDEN 个
+    int16_t biases[NNUE_HIDDEN];            // 累加器偏置
+    int16_t l2Weights[NNUE_L2][2 * NNUE_HIDDEN];  // 文件里是 int8，读入时扩展成 int16 方便做乘加
+    int32_t l2Biases[NNUE_L2];
+    int16_t outWeights[NNUE_L2];
+    int32_t outBias;
+} nnueStruct;
+
+extern nnueStruct Nnue;
+
+// 读入权重文件，失败时不用网络评价并返回 false；会把全局局面 pos 的累加器标记为要重算
+bool nnueLoad(const char* szFile);
+void nnueClose(void);
+
+// 用固定种子的随机权重代替权重文件，只用来测速和检查增量更新
+void nnueRandom(void);
+
+// 重算一个视角的累加器
+void nnueRefresh(positionStruct* pos, int side);
+
+// 网络评价，相对走子方的分值
+int nnueEvaluate(positionStruct* pos);
+
+// 使用的指令集
+const char* nnueSimd(void);
+
+// 一行权重加到(nSign 为 -1 时减去)累加器上
+inline void NNUE_UPDATE(int16_t* lpAcc, const int16_t* lpRow, int nSign) {
+    int i;
+#if defined(NNUE_AVX2)
+    for (i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(lpAcc + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(lpRow + i));
+        a = nSign > 0 ? _mm256_add_epi16(a, w) : _mm256_sub_epi16(a, w);
+        _mm256_storeu_si256((__m256i*)(lpAcc + i), a);
+    }
+#elif defined(NNUE_SSE2)
+    for (i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(lpAcc + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(lpRow + i));
+        a = nSign > 0 ? _mm_add_epi16(a, w) : _mm_sub_epi16(a, w);
+        _mm_storeu_si128((__m128i*)(lpAcc + i), a);
+    }
+#else
+    for (i = 0; i < NNUE_HIDDEN; i++) {
+        lpAcc[i] = (int16_t)(lpAcc[i] + nSign * lpRow[i]);
+    }
+#endif
+}
+
+// 从 side 的视角看，格子 id 上的棋子 type 对应的特征，idKing 是本方帅(将)的格子
+inline int NNUE_FEATURE(int side, int idKing, int id, int type) {
+    int nKing, nPiece;
+    if (side != 0) {
+        idKing = SQUARE_FLIP(idKing);
+        id = SQUARE_FLIP(id);
+    }
+    nKing = (Y(idKing) - RANK_BOTTOM + 2) * 3 + X(idKing) - FILE_LEFT - 3;
+    nPiece = (type & 7) + (SIDE_INDEX(type) == side ? 0 : 7);
+    return (nKing * 14 + nPiece) * 90 + (Y(id) - RANK_TOP) * 9 + X(id) - FILE_LEFT;
+}
+
+// addPiece、delPiece 调用：本方帅(将)动了或者还不在棋盘上就等重算，否则加减一行权重
+inline void nnueUpdate(positionStruct* pos, int id, int type, int nSign) {
+    int side;
+    if (!Nnue.bLoaded) {
+        return;
+    }
+    for (side = 0; side < 2; side++) {
+        if (pos->acc.bDirty[side]) {
+            continue;
+        }
+        if (type == SIDE_TAG(side) + PIECE_KING || pos->kingSquare[side] == 0) {
+            pos->acc.bDirty[side] = true;
+            continue;
+        }
+        NNUE_UPDATE(pos->acc.vls[side], Nnue.lpWeights +
+                    NNUE_FEATURE(side, pos->kingSquare[side], id, type) * NNUE_HIDDEN, nSign);
+    }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <chrono>
+#include "perft.h"
+
+// 参考值表：局面、深度和叶子节点数
+typedef struct perftEntry {
+    const char* szFen;
+    int nDepth;
+    int64_t nNodes;
+} perftEntry;
+
+const perftEntry perftTable[] = {
+    // 初始局面
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", 1, 44 },
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", 2, 1920 },
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", 3, 79666 },
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", 4, 3290240 },
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w", 5, 133312995 },
+    // 中局，有蹩马腿、塞象眼和炮架
+    { "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w", 1, 38 },
+    { "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w", 2, 1128 },
+    { "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w", 3, 43929 },
+    { "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w", 4, 1339047 },
+    // 残局，双方都有过河兵
+    { "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w", 1, 7 },
+    { "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w", 2, 281 },
+    { "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w", 3, 8620 },
+    { "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w", 4, 326201 },
+    // 残局，车马炮攻防
+    { "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w", 1, 25 },
+    { "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w", 2, 424 },
+    { "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w", 3, 9850 },
+    { "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w", 4, 202884 },
+};
+
+// 计时，返回毫秒
+int64_t perftClock(void) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t perft(positionStruct* pos, int nDepth) {
+    int i, nGenMoves, pcCaptured;
+    int mvs[MAX_GEN_MOVES];
+    int64_t nNodes = 0;
+    pinStruct pins;
+
+    if (nDepth == 0) {
+        return 1;
+    }
+    // 只生成合法的走法，最后一层不用走棋，直接数走法
+    initPins(pos, &pins);
+    nGenMoves = generateLegalMoves(pos, &pins, mvs);
+    if (nDepth == 1) {
+        return nGenMoves;
+    }
+    for (i = 0; i < nGenMoves; i++) {
+        makeLegalMove(pos, mvs[i], &pcCaptured);
+        nNodes += perft(pos, nDepth - 1);
+        undoMakeMove(pos, mvs[i], pcCaptured);
+    }
+    return nNodes;
+}
+
+int64_t divide(positionStruct* pos, int nDepth, bool bShowMoves) {
+    int i, nGenMoves, pcCaptured;
+    int mvs[MAX_GEN_MOVES];
+    char szMove[5];
+    int64_t n, nNodes = 0, t = perftClock();
+    pinStruct pins;
+
+    initPins(pos, &pins);
+    nGenMoves = generateLegalMoves(pos, &pins, mvs);
+    for (i = 0; i < nGenMoves; i++) {
+        makeLegalMove(pos, mvs[i], &pcCaptured);
+        n = nDepth <= 1 ? 1 : perft(pos, nDepth - 1);
+        undoMakeMove(pos, mvs[i], pcCaptured);
+        if (bShowMoves) {
+            moveToStr(mvs[i], szMove);
+            printf("%s %lld\n", szMove, (long long)n);
+        }
+        nNodes += n;
+    }
+    t = perftClock() - t;
+    printf("nodes %lld time %lld nps %lld\n", (long long)nNodes, (long long)t,
+           (long long)(nNodes * 1000 / (t > 0 ? t : 1)));
+    return nNodes;
+}
+
+bool perftSuite(int nMaxDepth) {
+    int i, nFailed = 0;
+    int64_t n, t, nTotal = 0, tTotal = 0;
+    positionStruct posTest;
+
+    for (i = 0; i < (int)(sizeof(perftTable) / sizeof(perftTable[0])); i++) {
+        if (perftTable[i].nDepth > nMaxDepth) {
+            continue;
+        }
+        fromFen(&posTest, perftTable[i].szFen);
+        t = perftClock();
+        n = perft(&posTest, perftTable[i].nDepth);
+        t = perftClock() - t;
+        nTotal += n;
+        tTotal += t;
+        if (n != perftTable[i].nNodes) {
+            nFailed++;
+        }
+        printf("%s %s depth %d nodes %lld expected %lld time %lld nps %lld\n",
+               n == perftTable[i].nNodes ? "ok    " : "FAILED", perftTable[i].szFen,
+               perftTable[i].nDepth, (long long)n, (long long)perftTable[i].nNodes,
+               (long long)t, (long long)(n * 1000 / (t > 0 ? t : 1)));
+    }
+    printf("%d failed, nodes %lld time %lld nps %lld\n", nFailed, (long long)nTotal,
+           (long long)tTotal, (long long)(nTotal * 1000 / (tTotal > 0 ? tTotal : 1)));
+    return nFailed == 0;
+}
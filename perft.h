@@ -0,0 +1,17 @@
+#ifndef LVENW_PERFT_H
+#define LVENW_PERFT_H
+
+// 走法生成器的正确性和速度测试：perft 统计到给定深度的叶子节点数
+
+#include "engine.h"
+
+// 统计 nDepth 层的叶子节点数
+int64_t perft(positionStruct* pos, int nDepth);
+
+// 统计并输出总数和每秒节点数，bShowMoves 为 true 时按根节点的每个走法分别输出(divide)
+int64_t divide(positionStruct* pos, int nDepth, bool bShowMoves);
+
+// 用内置的参考值表逐个校验，输出每一项的结果和速度，全部通过返回 true
+bool perftSuite(int nMaxDepth);
+
+#endif
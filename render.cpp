@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include "render.h"
+
+// 帧缓冲后端的颜色
+#define COLOR_BACKGROUND    0X000000
+#define COLOR_LINE          0XFFFF55
+#define COLOR_RED_PIECE     0X776611
+#define COLOR_BLACK_PIECE   0X555555
+#define COLOR_SELECTED      0X00EF6F
+#define COLOR_RED_TEXT      0XFF0000
+#define COLOR_BLACK_TEXT    0X000000
+#define COLOR_RING          0XA52A2A
+
+#define GLYPH_SCALE     4       // 字形每个点画成 4×4 个像素
+
+// 棋子的 5×7 字形，顺序和 FEN 串的字母 "KABNRCP" 一致，每行低 5 位，最高位在左
+const unsigned char pieceGlyphs[7][7] = {
+    {0X11, 0X12, 0X14, 0X18, 0X14, 0X12, 0X11},  // K
+    {0X0E, 0X11, 0X11, 0X1F, 0X11, 0X11, 0X11},  // A
+    {0X1E, 0X11, 0X11, 0X1E, 0X11, 0X11, 0X1E},  // B
+    {0X11, 0X19, 0X15, 0X13, 0X11, 0X11, 0X11},  // N
+    {0X1E, 0X11, 0X11, 0X1E, 0X14, 0X12, 0X11},  // R
+    {0X0E, 0X11, 0X10, 0X10, 0X10, 0X11, 0X0E},  // C
+    {0X1E, 0X11, 0X11, 0X1E, 0X10, 0X10, 0X10},  // P
+};
+
+// 以 (x, y) 为中心的棋子所在的矩形，截断到棋盘内
+inline rectStruct PIECE_RECT(int x, int y) {
+    rectStruct rc;
+    rc.left = x - PIECE_RADIUS < 0 ? 0 : x - PIECE_RADIUS;
+    rc.top = y - PIECE_RADIUS < 0 ? 0 : y - PIECE_RADIUS;
+    rc.right = x + PIECE_RADIUS > BOARD_WIDTH ? BOARD_WIDTH : x + PIECE_RADIUS;
+    rc.bottom = y + PIECE_RADIUS > BOARD_HEIGHT ? BOARD_HEIGHT : y + PIECE_RADIUS;
+    return rc;
+}
+
+inline bool RECT_INTERSECT(const rectStruct* rc1, const rectStruct* rc2) {
+    return rc1->left < rc2->right && rc2->left < rc1->right && rc1->top < rc2->bottom && rc2->top < rc1->bottom;
+}
+
+void renderInit(renderStruct* lpRender, renderBackend* lpBackend) {
+    memset(lpRender, 0, sizeof(renderStruct));
+    lpRender->lpBackend = lpBackend;
+    memset(lpRender->pcDrawn, 0XFF, sizeof(lpRender->pcDrawn));
+    lpBackend->drawBoardLayer(lpBackend->lpParam);
+}
+
+// 加入一个要重画的矩形，太多时返回 false
+bool addDirty(renderStruct* lpRender, rectStruct rc) {
+    if (lpRender->nDirty == MAX_DIRTY_RECTS) {
+        return false;
+    }
+    lpRender->rcDirty[lpRender->nDirty++] = rc;
+    return true;
+}
+
+// 按 board 上的棋子画一帧，移动的棋子另外画在 (xMoving, yMoving)
+void renderBoard(renderStruct* lpRender, const char* board, int idSelected) {
+    int i, id, pc;
+    bool bFull;
+    rectStruct rc;
+    renderBackend* lpBackend = lpRender->lpBackend;
+
+    // 1. 棋子变了的格子，以及移动的棋子上一帧和这一帧所在的矩形
+    lpRender->nDirty = 0;
+    bFull = false;
+    for (id = 0; id < 256; id++) {
+        if (!IN_BOARD(id)) {
+            continue;
+        }
+        pc = board[id] + (id == idSelected && board[id] != 0 ? 256 : 0);
+        if (pc != lpRender->pcDrawn[id]) {
+            bFull = !addDirty(lpRender, PIECE_RECT(X_CENTER(id), Y_CENTER(id))) || bFull;
+            lpRender->pcDrawn[id] = pc;
+        }
+    }
+    if (lpRender->bMoving) {
+        bFull = !addDirty(lpRender, lpRender->rcMoving) || bFull;
+    }
+    lpRender->bMoving = lpRender->pcMoving != 0;
+    if (lpRender->bMoving) {
+        lpRender->rcMoving = PIECE_RECT(lpRender->xMoving, lpRender->yMoving);
+        bFull = !addDirty(lpRender, lpRender->rcMoving) || bFull;
+    }
+    if (bFull) {
+        lpRender->nDirty = 1;
+        lpRender->rcDirty[0].left = lpRender->rcDirty[0].top = 0;
+        lpRender->rcDirty[0].right = BOARD_WIDTH;
+        lpRender->rcDirty[0].bottom = BOARD_HEIGHT;
+    }
+    if (lpRender->nDirty == 0) {
+        return;
+    }
+
+    // 2. 用棋盘层盖住这些矩形，再画和它们相交的棋子，移动的棋子最后画
+    for (i = 0; i < lpRender->nDirty; i++) {
+        lpBackend->restoreRect(lpBackend->lpParam, &lpRender->rcDirty[i]);
+        lpRender->nPixels += (int64_t)(lpRender->rcDirty[i].right - lpRender->rcDirty[i].left) *
+                             (lpRender->rcDirty[i].bottom - lpRender->rcDirty[i].top);
+    }
+    for (id = 0; id < 256; id++) {
+        if (!IN_BOARD(id) || board[id] == 0) {
+            continue;
+        }
+        rc = PIECE_RECT(X_CENTER(id), Y_CENTER(id));
+        for (i = 0; i < lpRender->nDirty; i++) {
+            if (RECT_INTERSECT(&rc, &lpRender->rcDirty[i])) {
+                lpBackend->drawPiece(lpBackend->lpParam, X_CENTER(id), Y_CENTER(id), board[id], id == idSelected);
+                break;
+            }
+        }
+    }
+    if (lpRender->pcMoving != 0) {
+        lpBackend->drawPiece(lpBackend->lpParam, lpRender->xMoving, lpRender->yMoving, lpRender->pcMoving, true);
+    }
+    lpBackend->present(lpBackend->lpParam, lpRender->rcDirty, lpRender->nDirty);
+    lpRender->nFrames++;
+}
+
+void renderFrame(renderStruct* lpRender, const positionStruct* pos, int idSelected) {
+    renderBoard(lpRender, pos->curboard, idSelected);
+}
+
+void renderMove(renderStruct* lpRender, const positionStruct* pos, int mv, int typeDst) {
+    char board[256];
+    int64_t t, tStart;
+    int idSrc = SRC(mv), idDst = DST(mv);
+
+    // 动画过程中起点是空的，终点还是被吃的棋子
+    memcpy(board, pos->curboard, sizeof(board));
+    board[idSrc] = 0;
+    board[idDst] = (char)typeDst;
+    lpRender->pcMoving = pos->curboard[idDst];
+
+    // 按经过的时间插值，最后一帧正好在终点
+    tStart = searchClock();
+    do {
+        t = searchClock() - tStart;
+        t = t < ANIMATE_TIME ? t : ANIMATE_TIME;
+        lpRender->xMoving = X_CENTER(idSrc) + (int)((X_CENTER(idDst) - X_CENTER(idSrc)) * t / ANIMATE_TIME);
+        lpRender->yMoving = Y_CENTER(idSrc) + (int)((Y_CENTER(idDst) - Y_CENTER(idSrc)) * t / ANIMATE_TIME);
+        renderBoard(lpRender, board, 0);
+        if (t < ANIMATE_TIME) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(ANIMATE_FRAME));
+        }
+    } while (t < ANIMATE_TIME);
+
+    // 棋子落到终点
+    lpRender->pcMoving = 0;
+    renderBoard(lpRender, pos->curboard, 0);
+}
+
+/********************************************** 软件帧缓冲 *******************************************************/
+
+bool fbInit(frameBuffer* fb, int nWidth, int nHeight) {
+    fb->nWidth = nWidth;
+    fb->nHeight = nHeight;
+    fb->lpPixels = (uint32_t*)calloc((size_t)nWidth * nHeight, sizeof(uint32_t));
+    fb->lpLayer = (uint32_t*)calloc((size_t)nWidth * nHeight, sizeof(uint32_t));
+    fb->szDumpDir = NULL;
+    fb->nDumped = 0;
+    if (fb->lpPixels == NULL || fb->lpLayer == NULL) {
+        fbClose(fb);
+        return false;
+    }
+    return true;
+}
+
+void fbClose(frameBuffer* fb) {
+    free(fb->lpPixels);
+    free(fb->lpLayer);
+    fb->lpPixels = fb->lpLayer = NULL;
+}
+
+// 画一个点，超出范围就忽略
+inline void fbPixel(uint32_t* lpPixels, const frameBuffer* fb, int x, int y, uint32_t color) {
+    if (x >= 0 && x < fb->nWidth && y >= 0 && y < fb->nHeight) {
+        lpPixels[y * fb->nWidth + x] = color;
+    }
+}
+
+// 两个像素宽的直线
+void fbLine(uint32_t* lpPixels, const frameBuffer* fb, int x1, int y1, int x2, int y2, uint32_t color) {
+    int dx = abs(x2 - x1), dy = -abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1, sy = y1 < y2 ? 1 : -1;
+    int e = dx + dy, e2;
+    for (;;) {
+        fbPixel(lpPixels, fb, x1, y1, color);
+        fbPixel(lpPixels, fb, x1 + 1, y1, color);
+        fbPixel(lpPixels, fb, x1, y1 + 1, color);
+        fbPixel(lpPixels, fb, x1 + 1, y1 + 1, color);
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        e2 = 2 * e;
+        if (e2 >= dy) {
+            e += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            e += dx;
+            y1 += sy;
+        }
+    }
+}
+
+// 半径在 [nInner, nOuter] 之间的圆环，nInner 为 0 就是实心圆
+void fbRing(uint32_t* lpPixels, const frameBuffer* fb, int x, int y, int nInner, int nOuter, uint32_t color) {
+    int dx, dy, d;
+    for (dy = -nOuter; dy <= nOuter; dy++) {
+        for (dx = -nOuter; dx <= nOuter; dx++) {
+            d = dx * dx + dy * dy;
+            if (d <= nOuter * nOuter && (nInner == 0 || d >= nInner * nInner)) {
+                fbPixel(lpPixels, fb, x + dx, y + dy, color);
+            }
+        }
+    }
+}
+
+void fbDrawBoardLayer(void* lpParam) {
+    frameBuffer* fb = (frameBuffer*)lpParam;
+    int i, n = fb->nWidth * fb->nHeight;
+
+    for (i = 0; i < n; i++) {
+        fb->lpLayer[i] = COLOR_BACKGROUND;
+    }
+    // 10 条横线，9 条竖线，中间的竖线在河界断开
+    for (i = 0; i < 10; i++) {
+        fbLine(fb->lpLayer, fb, BOARD_EDGE, BOARD_EDGE + i * PIECE_SIZE, BOARD_EDGE + 8 * PIECE_SIZE,
+               BOARD_EDGE + i * PIECE_SIZE, COLOR_LINE);
+    }
+    for (i = 0; i < 9; i++) {
+        if (i == 0 || i == 8) {
+            fbLine(fb->lpLayer, fb, BOARD_EDGE + i * PIECE_SIZE, BOARD_EDGE, BOARD_EDGE + i * PIECE_SIZE,
+                   BOARD_EDGE + 9 * PIECE_SIZE, COLOR_LINE);
+        }
+        else {
+            fbLine(fb->lpLayer, fb, BOARD_EDGE + i * PIECE_SIZE, BOARD_EDGE, BOARD_EDGE + i * PIECE_SIZE,
+                   BOARD_EDGE + 4 * PIECE_SIZE, COLOR_LINE);
+            fbLine(fb->lpLayer, fb, BOARD_EDGE + i * PIECE_SIZE, BOARD_EDGE + 5 * PIECE_SIZE,
+                   BOARD_EDGE + i * PIECE_SIZE, BOARD_EDGE + 9 * PIECE_SIZE, COLOR_LINE);
+        }
+    }
+    // 九宫的斜线
+    for (i = 0; i < 2; i++) {
+        fbLine(fb->lpLayer, fb, BOARD_EDGE + 3 * PIECE_SIZE, BOARD_EDGE + i * 7 * PIECE_SIZE,
+               BOARD_EDGE + 5 * PIECE_SIZE, BOARD_EDGE + (i * 7 + 2) * PIECE_SIZE, COLOR_LINE);
+        fbLine(fb->lpLayer, fb, BOARD_EDGE + 3 * PIECE_SIZE, BOARD_EDGE + (i * 7 + 2) * PIECE_SIZE,
+               BOARD_EDGE + 5 * PIECE_SIZE, BOARD_EDGE + i * 7 * PIECE_SIZE, COLOR_LINE);
+    }
+}
+
+void fbRestoreRect(void* lpParam, const rectStruct* rc) {
+    frameBuffer* fb = (frameBuffer*)lpParam;
+    int y;
+    for (y = rc->top; y < rc->bottom; y++) {
+        memcpy(fb->lpPixels + y * fb->nWidth + rc->left, fb->lpLayer + y * fb->nWidth + rc->left,
+               (size_t)(rc->right - rc->left) * sizeof(uint32_t));
+    }
+}
+
+void fbDrawPiece(void* lpParam, int x, int y, int type, bool bSelected) {
+    frameBuffer* fb = (frameBuffer*)lpParam;
+    int i, j, k;
+    bool bRed = (type & 8) != 0;
+    uint32_t colorText = bRed ? COLOR_RED_TEXT : COLOR_BLACK_TEXT;
+    const unsigned char* lpGlyph = pieceGlyphs[type & 7];
+
+    fbRing(fb->lpPixels, fb, x, y, 0, PIECE_RADIUS - 3,
+           bSelected ? COLOR_SELECTED : bRed ? COLOR_RED_PIECE : COLOR_BLACK_PIECE);
+    fbRing(fb->lpPixels, fb, x, y, PIECE_RADIUS - 7, PIECE_RADIUS - 6, bRed ? COLOR_RED_TEXT : COLOR_RING);
+    // 字形放在中心
+    for (i = 0; i < 7; i++) {
+        for (j = 0; j < 5; j++) {
+            if ((lpGlyph[i] & (0X10 >> j)) == 0) {
+                continue;
+            }
+            for (k = 0; k < GLYPH_SCALE * GLYPH_SCALE; k++) {
+                fbPixel(fb->lpPixels, fb, x + (j * 2 - 5) * GLYPH_SCALE / 2 + k % GLYPH_SCALE,
+                        y + (i * 2 - 7) * GLYPH_SCALE / 2 + k / GLYPH_SCALE, colorText);
+            }
+        }
+    }
+}
+
+void fbPresent(void* lpParam, const rectStruct* rcs, int nRects) {
+    frameBuffer* fb = (frameBuffer*)lpParam;
+    char szFile[1024];
+    if (fb->szDumpDir != NULL) {
+        snprintf(szFile, sizeof(szFile), "%s/frame%04d.ppm", fb->szDumpDir, fb->nDumped);
+        fb->nDumped++;
+        fbSavePpm(fb, szFile);
+    }
+}
+
+void fbBackend(frameBuffer* fb, renderBackend* lpBackend) {
+    lpBackend->lpParam = fb;
+    lpBackend->drawBoardLayer = fbDrawBoardLayer;
+    lpBackend->restoreRect = fbRestoreRect;
+    lpBackend->drawPiece = fbDrawPiece;
+    lpBackend->present = fbPresent;
+}
+
+bool fbSavePpm(const frameBuffer* fb, const char* szFile) {
+    FILE* fp;
+    int i, n = fb->nWidth * fb->nHeight;
+    unsigned char rgb[3];
+    bool bOk;
+
+    fp = fopen(szFile, "wb");
+    if (fp == NULL) {
+        return false;
+    }
+    bOk = fprintf(fp, "P6\n%d %d\n255\n", fb->nWidth, fb->nHeight) > 0;
+    for (i = 0; bOk && i < n; i++) {
+        rgb[0] = (unsigned char)(fb->lpPixels[i] >> 16);
+        rgb[1] = (unsigned char)(fb->lpPixels[i] >> 8);
+        rgb[2] = (unsigned char)fb->lpPixels[i];
+        bOk = fwrite(rgb, 1, 3, fp) == 3;
+    }
+    return fclose(fp) == 0 && bOk;
+}
+
+bool renderDump(const char* szDir) {
+    frameBuffer fb;
+    renderBackend backend;
+    renderStruct render;
+    positionStruct posDump;
+    int mv, pcCaptured;
+    int64_t nPixels;
+
+    if (!fbInit(&fb)) {
+        return false;
+    }
+    fb.szDumpDir = szDir;
+    fbBackend(&fb, &backend);
+    renderInit(&render, &backend);
+
+    // 1. 初始局面，第一帧重画整个棋盘
+    startup(&posDump);
+    renderFrame(&render, &posDump, 0);
+    printf("frame 0 pixels %lld\n", (long long)render.nPixels);
+
+    // 2. 选中炮，只重画一个格子
+    nPixels = render.nPixels;
+    renderFrame(&render, &posDump, COORD_XY(FILE_LEFT + 7, RANK_BOTTOM - 2));
+    printf("select pixels %lld\n", (long long)(render.nPixels - nPixels));
+
+    // 3. 炮二平五的动画
+    nPixels = render.nPixels;
+    mv = strToMove("h2e2");
+    makeMove(&posDump, mv, &pcCaptured);
+    renderMove(&render, &posDump, mv, pcCaptured);
+    printf("move frames %lld pixels %lld\n", (long long)(render.nFrames - 2),
+           (long long)(render.nPixels - nPixels));
+    printf("frames %d saved to %s, full frame %d pixels\n", fb.nDumped, szDir, BOARD_WIDTH * BOARD_HEIGHT);
+    fflush(stdout);
+    fbClose(&fb);
+    return fb.nDumped > 0;
+}
@@ -0,0 +1,89 @@
+#ifndef LVENW_RENDER_H
+#define LVENW_RENDER_H
+
+// 棋盘的绘制，与平台无关：具体怎么画由 renderBackend 完成，图形界面用 EasyX 实现(见 main.cpp)，
+// 这里另有一个软件帧缓冲的实现，可以在 Linux 上编译，把每一帧保存成 PPM 图片检查。
+// 1. 棋盘的线条只在初始化时画一次，画在缓存的棋盘层上；
+// 2. 每一帧和上一帧比较，只有棋子变了的格子和移动的棋子经过的矩形要重画：先从棋盘层恢复矩形，
+//    再画和矩形相交的棋子，移动的棋子最后画，总在最上面；
+// 3. 走棋动画按墙上时间插值，总时间是 ANIMATE_TIME，和走的距离、每帧的速度无关。
+
+#include "engine.h"
+
+#define PIECE_SIZE      64                  // 棋子大小，也是格子的间距
+#define BOARD_EDGE      40                  // 棋盘距离边界
+#define PIECE_RADIUS    (PIECE_SIZE / 2)    // 棋子半径
+#define BOARD_WIDTH     (PIECE_SIZE * 8 + 2 * BOARD_EDGE)
+#define BOARD_HEIGHT    (PIECE_SIZE * 9 + 2 * BOARD_EDGE)
+
+#define ANIMATE_TIME    200                 // 走棋动画的时间(毫秒)
+#define ANIMATE_FRAME   10                  // 动画每帧至少间隔的时间(毫秒)
+#define MAX_DIRTY_RECTS 32                  // 一帧最多的重画矩形数，超过就重画整个棋盘
+
+// 格子中心的像素坐标
+inline int X_CENTER(int id) {
+    return BOARD_EDGE + (X(id) - FILE_LEFT) * PIECE_SIZE;
+}
+
+inline int Y_CENTER(int id) {
+    return BOARD_EDGE + (Y(id) - RANK_TOP) * PIECE_SIZE;
+}
+
+// 像素矩形，不包括 right 列和 bottom 行
+typedef struct rectStruct {
+    int left, top, right, bottom;
+} rectStruct;
+
+// 绘制的后端，lpParam 是后端自己的数据
+typedef struct renderBackend {
+    void* lpParam;
+    void (*drawBoardLayer)(void* lpParam);                  // 画缓存的棋盘层，只在初始化时调用一次
+    void (*restoreRect)(void* lpParam, const rectStruct* rc);  // 用棋盘层盖住一个矩形
+    void (*drawPiece)(void* lpParam, int x, int y, int type, bool bSelected);  // (x, y) 是棋子的中心
+    void (*present)(void* lpParam, const rectStruct* rcs, int nRects);  // 显示这一帧画过的矩形
+} renderBackend;
+
+typedef struct renderStruct {
+    renderBackend* lpBackend;
+    int pcDrawn[256];           // 上一帧每个格子画的棋子，选中的加上 256，-1 表示要重画
+    int pcMoving;               // 正在移动的棋子，0 表示没有
+    int xMoving, yMoving;       // 移动的棋子的中心
+    rectStruct rcMoving;        // 上一帧移动的棋子所在的矩形，这一帧要恢复
+    bool bMoving;               // 上一帧有移动的棋子
+    rectStruct rcDirty[MAX_DIRTY_RECTS];
+    int nDirty;
+    int64_t nFrames;            // 画过的帧数和重画的像素数，比较重画的代价
+    int64_t nPixels;
+} renderStruct;
+
+// 画棋盘层，下一帧重画整个棋盘
+void renderInit(renderStruct* lpRender, renderBackend* lpBackend);
+
+// 画一帧，只重画和上一帧不同的部分，idSelected 是选中的棋子，0 表示没有
+void renderFrame(renderStruct* lpRender, const positionStruct* pos, int idSelected);
+
+// 局面已经走了 mv，typeDst 是被吃的棋子，画出棋子从起点移到终点的动画
+void renderMove(renderStruct* lpRender, const positionStruct* pos, int mv, int typeDst);
+
+// 软件帧缓冲，像素是 0X00RRGGBB
+typedef struct frameBuffer {
+    int nWidth, nHeight;
+    uint32_t* lpPixels;         // 当前的一帧
+    uint32_t* lpLayer;          // 缓存的棋盘层
+    const char* szDumpDir;      // 不为 NULL 时，每一帧保存成这个目录下的 "frameNNNN.ppm"
+    int nDumped;
+} frameBuffer;
+
+bool fbInit(frameBuffer* fb, int nWidth = BOARD_WIDTH, int nHeight = BOARD_HEIGHT);
+void fbClose(frameBuffer* fb);
+
+// 用帧缓冲实现的后端
+void fbBackend(frameBuffer* fb, renderBackend* lpBackend);
+
+// 保存成二进制的 PPM 图片
+bool fbSavePpm(const frameBuffer* fb, const char* szFile);
+
+// 画初始局面和一步走棋的动画，每一帧保存到 szDir 目录，输出帧数和重画的像素数
+bool renderDump(const char* szDir);
+
+#endif
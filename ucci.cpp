@@ -0,0 +1,412 @@
+// 无界面的 UCCI 引擎，通过标准输入输出和界面程序通信
+// 编译：g++ -O2 -DNDEBUG engine.cpp bitboard.cpp perft.cpp bench.cpp book.cpp mapfile.cpp egtb.cpp nnue.cpp batch.cpp epd.cpp render.cpp ucci.cpp -o lvenw-ucci -pthread
+// 加上 -DSEARCH_STATS 编译时，"setoption statsfile <文件>" 把每次迭代的搜索统计写成 JSON 行
+// "lvenw-ucci [置换表大小(MB)] [线程数]" 进入 UCCI 模式
+// "lvenw-ucci perft [深度]" 用参考值表校验走法生成器，不进入 UCCI 模式
+// "lvenw-ucci makebook <文本文件> <开局库文件>" 生成开局库，见 book.h
+// "lvenw-ucci maketb <子力组合> [目录]" 生成残局库，见 egtb.h
+// "lvenw-ucci smp [深度]" 测试 1/2/4/8/16/32 个线程搜索到给定深度的用时，不进入 UCCI 模式
+// "lvenw-ucci evalcheck [局面数] [余量1] [余量2]" 检查惰性评价和完整评价是否一致，不进入 UCCI 模式
+// "lvenw-ucci nnuebench [局面数]" 检查神经网络评价的增量更新并测速(定义 USE_NNUE 时)，不进入 UCCI 模式
+// "lvenw-ucci cache [深度]" 统计搜索到给定深度的一级数据缓存缺失次数(Linux)，不进入 UCCI 模式
+// "lvenw-ucci batch <文件> [工作线程数] [深度]" 用几个线程同时分析文件中的局面，见 batch.h，不进入 UCCI 模式
+// "lvenw-ucci epd <文件> [每题毫秒数] [每题节点数]" 逐题搜索 EPD 测试题，统计解题的深度、用时和节点数，见 epd.h
+// "lvenw-ucci render <目录>" 用软件帧缓冲画初始局面和一步走棋的动画，每一帧保存成 PPM 图片，见 render.h
+
+#include <stdio.h>
+#include <thread>
+#include "engine.h"
+#include "perft.h"
+#include "bench.h"
+#include "book.h"
+#include "egtb.h"
+#include "nnue.h"
+#include "batch.h"
+#include "epd.h"
+#include "render.h"
+
+#define LINE_INPUT_MAX  8192    // 一行命令的最大长度
+
+std::thread searchThread;       // 后台搜索线程，"go" 启动，"stop" 停止
+bool bUseBook = true;           // 是否使用开局库
+
+// 跳过空白字符
+const char* skipSpace(const char* p) {
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    return p;
+}
+
+// 命令是否以 szWord 开头，是则返回后面的内容，否则返回 NULL
+const char* startsWith(const char* p, const char* szWord) {
+    size_t n = strlen(szWord);
+    if (strncmp(p, szWord, n) != 0 || (p[n] != '\0' && p[n] != ' ')) {
+        return NULL;
+    }
+    return skipSpace(p + n);
+}
+
+// 开关型选项的值，"true" 或 "on" 表示打开
+bool optionOn(const char* p) {
+    return startsWith(p, "true") != NULL || startsWith(p, "on") != NULL;
+}
+
+// 等待后台搜索结束
+void waitSearch(bool bStop) {
+    if (searchThread.joinable()) {
+        if (bStop) {
+            Search.bStop = true;
+        }
+        searchThread.join();
+    }
+}
+
+// "position {fen <fen> | startpos} [moves <m1> <m2> ...]"
+void ucciPosition(const char* p) {
+    const char* q;
+    int mv, pcCaptured;
+
+    if ((q = startsWith(p, "startpos")) != NULL) {
+        startup(&pos);
+    }
+    else if ((q = startsWith(p, "fen")) != NULL) {
+        if (!fromFen(&pos, q)) {
+            startup(&pos);
+        }
+    }
+    else {
+        return;
+    }
+
+    // 逐个走后续的走法，走法不合理就忽略剩下的部分
+    q = strstr(q, "moves");
+    if (q == NULL) {
+        return;
+    }
+    q = skipSpace(q + 5);
+    while (*q != '\0') {
+        mv = strToMove(q);
+        if (mv == 0 || !legalMove(&pos, mv) || !makeMove(&pos, mv, &pcCaptured)) {
+            break;
+        }
+        // 吃子以前的局面不会再重复，历史走法栈太长时也从头记录，给搜索留出空间
+        if (pcCaptured != 0 || pos.nMoveNum > MAX_MOVE_NUM / 2) {
+            setIrreversible(&pos);
+        }
+        q = skipSpace(q + 4);
+    }
+    pos.nDistance = 0;
+}
+
+// 后台线程：搜索并输出最佳走法，开局库里有就不搜索
+void searchAndReport(void) {
+    char szMove[5];
+    int mv = bUseBook ? bookProbe(&pos) : 0;
+    if (mv != 0) {
+        // 后台思考、无限思考时也要等到命中或者停止才能给出走法
+        ponderWait();
+        Search.bPonder = false;
+        Search.bInfinite = false;
+        moveToStr(mv, szMove);
+        printf("info string book\nbestmove %s\n", szMove);
+        fflush(stdout);
+        return;
+    }
+    searchMain();
+    printf("info depth %d score %d time %lld nodes %lld\n", Search.nDepthResult, Search.vlResult,
+           (long long)(searchClock() - Search.tStart), (long long)Search.nNodes);
+    printf("info string lmr reduced %lld plies %lld researched %lld\n", (long long)Search.nLmrReduced,
+           (long long)Search.nLmrPlies, (long long)Search.nLmrResearched);
+    if (Search.mvResult == 0) {
+        printf("nobestmove\n");
+    }
+    else {
+        moveToStr(Search.mvResult, szMove);
+        printf("bestmove %s", szMove);
+        if (Search.mvPonder != 0) {
+            moveToStr(Search.mvPonder, szMove);
+            printf(" ponder %s", szMove);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+// "go [ponder] [depth <d> | nodes <n> | movetime <ms> | time <ms> [increment <ms>] [movestogo <n>] | infinite]"
+// "time" 是棋钟的剩余时间，"movetime" 是每步的思考时间(扩展)。
+// "ponder" 是后台思考：局面里已经走了预测的对方应着，"ponderhit" 之后才开始按限制计时，
+// 没有命中时界面发 "stop"，这时给出的走法不用。"infinite" 是无限思考，找到杀棋也要等到 "stop" 才给出走法
+void ucciGo(const char* p) {
+    const char* q;
+
+    Search.nMaxDepth = 0;
+    Search.nMaxTime = 0;
+    Search.nClockTime = 0;
+    Search.nIncrement = 0;
+    Search.nMovesToGo = 0;
+    Search.nMaxNodes = 0;
+    Search.bPonder = false;
+    Search.bInfinite = false;
+    while (*p != '\0') {
+        if (startsWith(p, "ponder") != NULL) {
+            Search.bPonder = true;
+        }
+        else if (startsWith(p, "infinite") != NULL) {
+            Search.bInfinite = true;
+        }
+        else if ((q = startsWith(p, "depth")) != NULL) {
+            Search.nMaxDepth = atoi(q);
+        }
+        else if ((q = startsWith(p, "movetime")) != NULL) {
+            Search.nMaxTime = atoi(q) > 0 ? atoi(q) : 1;
+        }
+        else if ((q = startsWith(p, "time")) != NULL) {
+            Search.nClockTime = atoi(q) > 0 ? atoi(q) : 1;
+        }
+        else if ((q = startsWith(p, "increment")) != NULL) {
+            Search.nIncrement = atoi(q);
+        }
+        else if ((q = startsWith(p, "movestogo")) != NULL) {
+            Search.nMovesToGo = atoi(q);
+        }
+        else if ((q = startsWith(p, "nodes")) != NULL) {
+            Search.nMaxNodes = atoll(q);
+        }
+        // 跳到下一个单词
+        while (*p != '\0' && *p != ' ') {
+            p++;
+        }
+        p = skipSpace(p);
+    }
+
+    Search.bStop = false;
+    searchThread = std::thread(searchAndReport);
+}
+
+int main(int argc, char* argv[]) {
+    char szLine[LINE_INPUT_MAX];
+    const char* p;
+    const char* q;
+    size_t n;
+
+    // 第一个参数是置换表大小(MB)，第二个参数是搜索线程数
+    int nHashMB = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : HASH_SIZE_MB;
+    if (!hashInit(nHashMB) && !hashInit(HASH_SIZE_MB)) {
+        return 1;
+    }
+    if (!threadsInit(argc > 2 ? atoi(argv[2]) : 1)) {
+        return 1;
+    }
+    initEngine();
+    startup(&pos);
+
+    // perft 校验模式
+    if (argc > 1 && strcmp(argv[1], "perft") == 0) {
+        return perftSuite(argc > 2 ? atoi(argv[2]) : 4) ? 0 : 1;
+    }
+
+    // 生成开局库
+    if (argc > 3 && strcmp(argv[1], "makebook") == 0) {
+        return bookMake(argv[2], argv[3]) ? 0 : 1;
+    }
+    bookOpen(BOOK_FILE);
+
+    // 生成残局库
+    if (argc > 2 && strcmp(argv[1], "maketb") == 0) {
+        return egtbMake(argv[2], argc > 3 ? argv[3] : EGTB_DIR) ? 0 : 1;
+    }
+    egtbInit(EGTB_DIR);
+
+#ifdef USE_NNUE
+    // 神经网络评价，没有权重文件时用原来的评价
+    nnueLoad(NNUE_FILE);
+    if (argc > 1 && strcmp(argv[1], "nnuebench") == 0) {
+        benchNnue(argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+#endif
+
+    // 多线程加速比测试模式
+    if (argc > 1 && strcmp(argv[1], "smp") == 0) {
+        benchThreads(argc > 2 ? atoi(argv[2]) : 8);
+        return 0;
+    }
+
+    // 惰性评价检查模式，可以临时指定两层余量
+    if (argc > 1 && strcmp(argv[1], "evalcheck") == 0) {
+        Search.vlLazyMargin1 = argc > 3 ? atoi(argv[3]) : LAZY_MARGIN_1;
+        Search.vlLazyMargin2 = argc > 4 ? atoi(argv[4]) : LAZY_MARGIN_2;
+        benchEval(argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+
+    // 缓存缺失测试模式
+    if (argc > 1 && strcmp(argv[1], "cache") == 0) {
+        benchCache(argc > 2 ? atoi(argv[2]) : 8);
+        return 0;
+    }
+
+    // 批量分析模式，默认每个核一个工作线程
+    if (argc > 2 && strcmp(argv[1], "batch") == 0) {
+        return batchAnalyse(argv[2], argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : BATCH_DEPTH) ? 0 : 1;
+    }
+
+    // 保存绘制的每一帧，检查界面的绘制
+    if (argc > 2 && strcmp(argv[1], "render") == 0) {
+        return renderDump(argv[2]) ? 0 : 1;
+    }
+
+    // EPD 测试题模式，默认每题 1 秒，不限节点数
+    if (argc > 2 && strcmp(argv[1], "epd") == 0) {
+        return epdSuite(argv[2], argc > 3 ? atoi(argv[3]) : EPD_TIME, argc > 4 ? atoll(argv[4]) : 0) ? 0 : 1;
+    }
+
+    while (fgets(szLine, LINE_INPUT_MAX, stdin) != NULL) {
+        n = strlen(szLine);
+        while (n > 0 && (szLine[n - 1] == '\n' || szLine[n - 1] == '\r')) {
+            szLine[--n] = '\0';
+        }
+        p = skipSpace(szLine);
+
+        if (startsWith(p, "ucci") != NULL) {
+            printf("id name lvenw\n");
+            printf("id author luuyiran\n");
+            printf("option hashsize type spin min 1 max 4096 default %d\n", HASH_SIZE_MB);
+            printf("option threads type spin min 1 max %d default 1\n", MAX_THREADS);
+            printf("option pvs type check default true\n");
+            printf("option aspiration type check default true\n");
+            printf("option nullmove type check default true\n");
+            printf("option nullverify type check default false\n");
+            printf("option lmr type check default true\n");
+            printf("option lazymargin1 type spin min 0 max %d default %d\n", MATE_VALUE, LAZY_MARGIN_1);
+            printf("option lazymargin2 type spin min 0 max %d default %d\n", MATE_VALUE, LAZY_MARGIN_2);
+            printf("option usebook type check default true\n");
+            printf("option bookfiles type string default %s\n", BOOK_FILE);
+            printf("option egtbpath type string default %s\n", EGTB_DIR);
+#ifdef USE_NNUE
+            printf("option evalfile type string default %s\n", NNUE_FILE);
+#endif
+#ifdef SEARCH_STATS
+            printf("option statsfile type string default none\n");
+#endif
+            printf("ucciok\n");
+        }
+        else if (startsWith(p, "isready") != NULL) {
+            printf("readyok\n");
+        }
+        else if ((q = startsWith(p, "setoption")) != NULL) {
+            // 置换表大小、线程数和搜索算法的开关
+            if ((p = startsWith(q, "hashsize")) != NULL) {
+                waitSearch(true);
+                if (!hashInit(atoi(p))) {
+                    hashInit(HASH_SIZE_MB);
+                }
+            }
+            else if ((p = startsWith(q, "threads")) != NULL) {
+                waitSearch(true);
+                threadsInit(atoi(p));
+            }
+            else if ((p = startsWith(q, "pvs")) != NULL) {
+                waitSearch(true);
+                Search.bPvs = optionOn(p);
+            }
+            else if ((p = startsWith(q, "aspiration")) != NULL) {
+                waitSearch(true);
+                Search.bAspiration = optionOn(p);
+            }
+            else if ((p = startsWith(q, "nullmove")) != NULL) {
+                waitSearch(true);
+                Search.bNullMove = optionOn(p);
+            }
+            else if ((p = startsWith(q, "nullverify")) != NULL) {
+                waitSearch(true);
+                Search.bNullVerify = optionOn(p);
+            }
+            else if ((p = startsWith(q, "usebook")) != NULL) {
+                waitSearch(true);
+                bUseBook = optionOn(p);
+            }
+            else if ((p = startsWith(q, "bookfiles")) != NULL) {
+                waitSearch(true);
+                bookOpen(p);
+            }
+            else if ((p = startsWith(q, "egtbpath")) != NULL) {
+                waitSearch(true);
+                egtbInit(p);
+            }
+#ifdef USE_NNUE
+            else if ((p = startsWith(q, "evalfile")) != NULL) {
+                waitSearch(true);
+                if (!nnueLoad(p)) {
+                    printf("info string evalfile not loaded, using classic evaluation\n");
+                }
+            }
+#endif
+#ifdef SEARCH_STATS
+            else if ((p = startsWith(q, "statsfile")) != NULL) {
+                // 每次迭代追加一行 JSON 统计，"none" 不写
+                waitSearch(true);
+                if (Search.fpStats != NULL) {
+                    fclose(Search.fpStats);
+                    Search.fpStats = NULL;
+                }
+                if (strcmp(p, "none") != 0 && (Search.fpStats = fopen(p, "a")) == NULL) {
+                    printf("info string cannot open statsfile %s\n", p);
+                }
+            }
+#endif
+            else if ((p = startsWith(q, "lmr")) != NULL) {
+                waitSearch(true);
+                Search.bLmr = optionOn(p);
+            }
+            else if ((p = startsWith(q, "lazymargin1")) != NULL) {
+                waitSearch(true);
+                Search.vlLazyMargin1 = atoi(p);
+            }
+            else if ((p = startsWith(q, "lazymargin2")) != NULL) {
+                waitSearch(true);
+                Search.vlLazyMargin2 = atoi(p);
+            }
+        }
+        else if ((q = startsWith(p, "position")) != NULL) {
+            waitSearch(true);
+            ucciPosition(q);
+        }
+        else if ((q = startsWith(p, "go")) != NULL) {
+            waitSearch(true);
+            ucciGo(q);
+        }
+        else if ((q = startsWith(p, "perft")) != NULL) {
+            // 扩展命令，统计当前局面的叶子节点数
+            waitSearch(true);
+            divide(&pos, atoi(q) > 0 ? atoi(q) : 1, false);
+        }
+        else if ((q = startsWith(p, "divide")) != NULL) {
+            // 扩展命令，按根节点的走法分别统计
+            waitSearch(true);
+            divide(&pos, atoi(q) > 0 ? atoi(q) : 1, true);
+        }
+        else if ((q = startsWith(p, "bench")) != NULL) {
+            // 扩展命令，按当前选项把测试局面搜索到固定深度，比较节点数
+            waitSearch(true);
+            benchSearch(atoi(q) > 0 ? atoi(q) : 8);
+        }
+        else if (startsWith(p, "ponderhit") != NULL) {
+            // 后台思考命中，搜索继续，从现在开始计时
+            ponderHit();
+        }
+        else if (startsWith(p, "stop") != NULL) {
+            waitSearch(true);
+        }
+        else if (startsWith(p, "quit") != NULL) {
+            waitSearch(true);
+            printf("bye\n");
+            fflush(stdout);
+            break;
+        }
+        fflush(stdout);
+    }
+    waitSearch(true);
+    return 0;
+}